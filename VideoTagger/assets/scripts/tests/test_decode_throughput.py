@@ -0,0 +1,93 @@
+import time
+from vt import *
+
+
+# Times the playback of the open video group once with whole frame conversion and once with sliced conversion,
+# and reports how many frames every video decoded and converted per second in both modes side by side
+# Run it with groups of 1080p and 4K videos and with different numbers of videos to compare the throughput
+class test_decode_throughput(Script):
+	def __init__(self):
+		Script.__init__(self)
+		self.warmup_seconds = 1
+		self.measure_seconds = 10
+		self.apply_timeout_seconds = 5
+		# One scale thread converts the whole frame on the pipeline thread, more split it into slices
+		self.modes = [("whole frame", 1), ("sliced", 4)]
+
+	def has_progress(self: Script) -> bool:
+		return False
+
+	def wait_for_scale_threads(self, count: int) -> bool:
+		start_time = time.perf_counter()
+		while time.perf_counter() - start_time < self.apply_timeout_seconds:
+			if all(stats.scale_threads == count for stats in player.pipeline_stats):
+				return True
+			time.sleep(0.05)
+		return False
+
+	def measure(self, scale_threads: int):
+		player.set_scale_threads(scale_threads)
+		if not self.wait_for_scale_threads(scale_threads):
+			error(f"The videos didn't switch to {scale_threads} scale threads")
+			return None
+
+		player.seek(Timestamp(0))
+		player.play()
+		time.sleep(self.warmup_seconds)
+
+		start_stats = {stats.video_id: stats for stats in player.pipeline_stats}
+		start_time = time.perf_counter()
+		time.sleep(self.measure_seconds)
+		end_stats = player.pipeline_stats
+		elapsed = time.perf_counter() - start_time
+		player.pause()
+
+		result = {}
+		for stats in end_stats:
+			before = start_stats.get(stats.video_id)
+			if before is None:
+				continue
+
+			result[stats.video_id] = (
+				(stats.decoded_frames - before.decoded_frames) / elapsed,
+				stats.dropped_frames - before.dropped_frames,
+				stats.consumer_stalls - before.consumer_stalls,
+				stats.decode_threads
+			)
+		return result
+
+	def on_run(self) -> None:
+		project = current_project()
+		if project is None or len(player.pipeline_stats) == 0:
+			error("No videos are displayed, open a video group first")
+			return
+
+		results = []
+		for name, scale_threads in self.modes:
+			result = self.measure(scale_threads)
+			if result is None:
+				break
+			results.append(result)
+		player.set_scale_threads(None)
+
+		if len(results) != len(self.modes):
+			return
+
+		totals = {}
+		for video_id in results[0]:
+			video = project.get_video(video_id)
+			size = video.size if video is not None else (0, 0)
+			resolution = f"{size[0]}x{size[1]}"
+			columns = []
+			for (name, scale_threads), result in zip(self.modes, results):
+				frame_rate, dropped, stalls, decode_threads = result.get(video_id, (0.0, 0, 0, 0))
+				columns.append(f"{name} ({scale_threads} scale threads) {frame_rate:.1f} frames/s, {dropped} dropped, {stalls} stalls")
+				resolution_totals = totals.setdefault(resolution, [0.0] * len(self.modes))
+				resolution_totals[len(columns) - 1] += frame_rate
+
+			log(f"Video {video_id} ({resolution}, {decode_threads} decode threads): " + " | ".join(columns))
+
+		for resolution, frame_rates in totals.items():
+			columns = [f"{name} {frame_rate:.1f} frames/s" for (name, _), frame_rate in zip(self.modes, frame_rates)]
+			speedup = frame_rates[-1] / frame_rates[0] if frame_rates[0] > 0 else 0
+			log(f"{resolution} in total: " + " | ".join(columns) + f", {speedup:.2f}x with sliced conversion")
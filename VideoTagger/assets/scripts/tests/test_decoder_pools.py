@@ -0,0 +1,54 @@
+import time
+from vt import *
+
+
+# Packets and frames are recycled by the decoders, so once playback has warmed up the pools shouldn't allocate anymore
+# The packet and frame queues only grow when a push finds them full, after warm-up they shouldn't grow either
+# Open a video group before running the test
+class test_decoder_pools(Script):
+	def __init__(self):
+		Script.__init__(self)
+		self.warmup_seconds = 2
+		self.measure_seconds = 5
+
+	def has_progress(self: Script) -> bool:
+		return False
+
+	def on_run(self) -> None:
+		if len(player.pool_stats) == 0:
+			error("No videos are displayed, open a video group first")
+			return
+
+		player.seek(Timestamp(0))
+		player.play()
+		time.sleep(self.warmup_seconds)
+		warm = {stats.video_id: stats for stats in player.pool_stats}
+
+		time.sleep(self.measure_seconds)
+		player.pause()
+
+		failed = False
+		for stats in player.pool_stats:
+			before = warm.get(stats.video_id)
+			if before is None:
+				continue
+
+			packet_allocations = stats.packet_allocations - before.packet_allocations
+			frame_allocations = stats.frame_allocations - before.frame_allocations
+			log(
+				f"Video {stats.video_id}: {packet_allocations} packet and {frame_allocations} frame allocations after warm-up, "
+				f"{stats.packet_reuses - before.packet_reuses} packet and {stats.frame_reuses - before.frame_reuses} frame reuses"
+			)
+			if packet_allocations != 0 or frame_allocations != 0:
+				error(f"Video {stats.video_id} still allocates after warm-up")
+				failed = True
+
+			if stats.packet_queue_slots != before.packet_queue_slots or stats.frame_queue_slots != before.frame_queue_slots:
+				error(
+					f"Video {stats.video_id} queues grew after warm-up, packet queues from {before.packet_queue_slots} to {stats.packet_queue_slots} slots, "
+					f"frame queue from {before.frame_queue_slots} to {stats.frame_queue_slots} slots"
+				)
+				failed = True
+
+		if not failed:
+			log("Pools and queues stopped allocating after warm-up")
@@ -0,0 +1,63 @@
+import os
+import time
+from vt import *
+
+
+# Imports every video in a directory and times the import and the background hashing separately
+# Point it at a directory with a few multi-GB videos, the file cache has to be cleared first to measure cold hashing
+class test_import_throughput(Script):
+	def __init__(self):
+		Script.__init__(self)
+		self.directory = "assets/samples"
+		self.extensions = {".mp4", ".mkv", ".avi", ".mov", ".webm"}
+		self.timeout_seconds = 600
+
+	def has_progress(self: Script) -> bool:
+		return False
+
+	def on_run(self) -> None:
+		project = current_project()
+		if project is None:
+			error("Failed to get current project")
+			return
+
+		paths = [
+			os.path.join(self.directory, name) for name in sorted(os.listdir(self.directory))
+			if os.path.splitext(name)[1].lower() in self.extensions
+		]
+		if len(paths) == 0:
+			error(f"No videos found in '{self.directory}'")
+			return
+
+		start_time = time.perf_counter()
+		videos = []
+		total_bytes = 0
+		for path in paths:
+			video = project.import_video(path)
+			if video is None:
+				log(f"Skipped '{path}', it failed to import or is already imported")
+				continue
+			videos.append(video)
+			total_bytes += os.path.getsize(path)
+		import_time = time.perf_counter() - start_time
+
+		if len(videos) == 0:
+			error("No videos were imported")
+			return
+
+		# The hashes are computed by background jobs, a video removed as a duplicate doesn't have to be waited for
+		pending = list(videos)
+		while len(pending) > 0 and time.perf_counter() - start_time < self.timeout_seconds:
+			pending = [video for video in pending if project.get_video(video.id) is not None and video.sha256 is None]
+			time.sleep(0.05)
+		hash_time = time.perf_counter() - start_time
+
+		megabytes = total_bytes / (1024 * 1024)
+		log(f"Imported {len(videos)} videos ({megabytes:.1f} MB) in {import_time:.2f}s, {len(videos) / import_time:.1f} videos/s")
+		if len(pending) > 0:
+			error(f"{len(pending)} videos weren't hashed after {self.timeout_seconds}s")
+		else:
+			log(f"Hashed in {hash_time:.2f}s after the import started, {megabytes / hash_time:.1f} MB/s")
+
+		for video in videos:
+			project.remove_video(video)
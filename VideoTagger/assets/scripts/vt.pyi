@@ -48,6 +48,41 @@ class Player:
     def set_playing(self: Player, value: bool) -> None: ...
     @property
     def is_playing(self: Player) -> bool: ...
+    def set_scale_threads(self: Player, count: Optional[int]) -> None: ...
+    @property
+    def pool_stats(self: Player) -> List[PoolStats]: ...
+    @property
+    def pipeline_stats(self: Player) -> List[PipelineStats]: ...
+
+class PipelineStats:
+    @property
+    def video_id(self: PipelineStats) -> int: ...
+    @property
+    def decoded_frames(self: PipelineStats) -> int: ...
+    @property
+    def dropped_frames(self: PipelineStats) -> int: ...
+    @property
+    def consumer_stalls(self: PipelineStats) -> int: ...
+    @property
+    def decode_threads(self: PipelineStats) -> int: ...
+    @property
+    def scale_threads(self: PipelineStats) -> int: ...
+
+class PoolStats:
+    @property
+    def video_id(self: PoolStats) -> int: ...
+    @property
+    def packet_allocations(self: PoolStats) -> int: ...
+    @property
+    def packet_reuses(self: PoolStats) -> int: ...
+    @property
+    def frame_allocations(self: PoolStats) -> int: ...
+    @property
+    def frame_reuses(self: PoolStats) -> int: ...
+    @property
+    def packet_queue_slots(self: PoolStats) -> int: ...
+    @property
+    def frame_queue_slots(self: PoolStats) -> int: ...
 
 class TagAttributeType(Enum):
     bool = 0
@@ -146,6 +181,8 @@ class Video:
     def path(self: Video) -> str: ...
     @property
     def size(self: Video) -> Tuple[int, int]: ...
+    @property
+    def sha256(self: Video) -> Optional[str]: ...
 
 class VideoInfo:
     @property
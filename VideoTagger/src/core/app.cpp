@@ -155,6 +155,13 @@ namespace vt
 	{
 		if (ctx_.state_ != app_state::shutdown) return;
 
+		// Running jobs use the project and the caches of the context, so they have to be done before any of them is destroyed
+		if (ctx_.current_project.has_value())
+		{
+			ctx_.current_project->job_token.cancel();
+		}
+		ctx_.jobs.stop();
+
 		ImGui_ImplOpenGL3_Shutdown();
 		ImGui_ImplSDL2_Shutdown();
 		ImGui::DestroyContext();
@@ -54,7 +54,9 @@ namespace vt
 
 	void app_context::update_current_video_group()
 	{
+		displayed_videos.set_focused_video(last_focused_video);
 		displayed_videos.update();
+		update_next_group_preload();
 	}
 
 	void app_context::reset_current_video_group()
@@ -100,6 +102,10 @@ namespace vt
 		video_timeline.selected_segment.reset();
 		insert_segment_data.clear();
 
+		for (auto& video_data : displayed_videos)
+		{
+			stream_cache.insert(video_data.id, std::move(video_data.video));
+		}
 		displayed_videos.clear();
 		
 		if (id == invalid_video_group_id)
@@ -107,6 +113,9 @@ namespace vt
 			return;
 		}
 
+		auto preload = std::move(next_group_preload_);
+		next_group_preload_ = {};
+
 		for (auto& group_inf : current_project->video_groups.at(id))
 		{
 			auto& vid_resource = current_project->videos.get(group_inf.id);
@@ -117,7 +126,28 @@ namespace vt
 				continue;
 			}
 
-			displayed_videos.insert(vid_resource.id(), vid_resource.video(), group_inf.offset, *metadata.width, *metadata.height);
+			video_stream video;
+			if (preload.group_id == id)
+			{
+				auto preloaded_it = std::find_if(preload.videos.begin(), preload.videos.end(), [&group_inf](const preloaded_video& preloaded)
+				{
+					return preloaded.id == group_inf.id;
+				});
+
+				// Waits if it's still opening, which is still faster than starting over
+				if (preloaded_it != preload.videos.end() and preloaded_it->video.valid())
+				{
+					video = preloaded_it->video.get();
+				}
+			}
+
+			if (!video.is_open())
+			{
+				video = vid_resource.video();
+			}
+
+			auto it = displayed_videos.insert(vid_resource.id(), std::move(video), group_inf.offset, *metadata.width, *metadata.height).first;
+			it->video.set_frame_cache_budget(static_cast<size_t>(app_settings.frame_cache_size) * 1024 * 1024);
 		}
 
 		ctx_.reset_player_docking = true;
@@ -127,4 +157,74 @@ namespace vt
 	{
 		return current_video_group_id_;
 	}
+
+	void app_context::update_next_group_preload()
+	{
+		video_group_id_t next_group_id = invalid_video_group_id;
+		if (current_project.has_value())
+		{
+			auto& playlist = current_project->video_group_playlist;
+			auto it = playlist.peek_next();
+			if (it != playlist.end() and *it != current_video_group_id_ and current_project->video_groups.count(*it) != 0)
+			{
+				next_group_id = *it;
+			}
+		}
+
+		if (next_group_id == next_group_preload_.group_id)
+		{
+			return;
+		}
+
+		// Streams that are still opening are destroyed by the workers when they finish
+		preload_token_.cancel();
+		preload_token_ = {};
+		next_group_preload_ = {};
+		next_group_preload_.group_id = next_group_id;
+
+		if (next_group_id == invalid_video_group_id)
+		{
+			return;
+		}
+
+		size_t frame_cache_budget = static_cast<size_t>(app_settings.frame_cache_size) * 1024 * 1024;
+		for (auto& group_inf : current_project->video_groups.at(next_group_id))
+		{
+			auto& vid_resource = current_project->videos.get(group_inf.id);
+			// Cached streams are already open
+			if (!vid_resource.playable() or stream_cache.contains(group_inf.id))
+			{
+				continue;
+			}
+
+			// Only copies, the resource might be gone before the job runs
+			std::filesystem::path path = vid_resource.file_path();
+			auto index = vid_resource.get_frame_index();
+			auto proxy_path = vid_resource.has_proxy() ? vid_resource.proxy_path() : std::filesystem::path{};
+
+			auto video = jobs.submit(utils::job_priority::interactive, [path, index, proxy_path, frame_cache_budget]()
+			{
+				video_stream result;
+				if (!result.open_file(path))
+				{
+					debug::warn("Failed to preload video from path {}", path.u8string());
+					return result;
+				}
+
+				result.set_frame_index(index);
+				if (!proxy_path.empty())
+				{
+					result.set_proxy_file(proxy_path);
+				}
+				result.set_frame_cache_budget(frame_cache_budget);
+
+				// The first frame is ready to be uploaded right after switching
+				result.seek(std::chrono::nanoseconds{ 0 });
+				result.prepare_frame(result.width(), result.height());
+				return result;
+			}, preload_token_);
+
+			next_group_preload_.videos.push_back({ group_inf.id, std::move(video) });
+		}
+	}
 }
@@ -36,9 +36,12 @@
 #include <utils/json.hpp>
 #include <utils/vec.hpp>
 #include <utils/file_node.hpp>
+#include <utils/job_scheduler.hpp>
 #include <scripts/scripting_engine.hpp>
 #include <services/service_account_manager.hpp>
 #include <video/video_importer.hpp>
+#include <video/video_stream_cache.hpp>
+#include <video/video_probe_cache.hpp>
 
 #include <editor/registry.hpp>
 
@@ -65,6 +68,15 @@ namespace vt
 		bool link_start_end_segment = true;
 		bool autoplay = true;
 		bool load_thumbnails = true;
+		//Textures of the thumbnail atlas, in megabytes
+		int thumbnail_memory_budget = 128;
+		//Per video, in megabytes
+		int frame_cache_size = 256;
+		//Number of videos that are kept open after they stop being displayed
+		int warm_video_cache_size = static_cast<int>(video_stream_cache::default_limit);
+		bool generate_proxies = false;
+		int proxy_height = 360;
+		bool show_filmstrip = true;
 		bool clear_console_on_run = true;
 		bool enable_undocking = true;
 		bool enable_gizmo_scaling = false;
@@ -92,8 +104,23 @@ namespace vt
 		bool show_script_progress = false;
 	};
 
+	struct preloaded_video
+	{
+		video_id_t id{};
+		std::future<video_stream> video;
+	};
+
+	//Videos of the next group in the playlist, opened in the background so switching to it doesn't stall
+	struct video_group_preload
+	{
+		video_group_id_t group_id = invalid_video_group_id;
+		std::vector<preloaded_video> videos;
+	};
+
 	struct app_context
 	{
+		//Shared by every kind of background work, stopped by app::shutdown before the members its jobs use are destroyed
+		utils::job_scheduler jobs{ std::thread::hardware_concurrency() };
 		std::optional<project> current_project;
 		widgets::video_timeline video_timeline;
 		widgets::project_selector project_selector;
@@ -117,6 +144,9 @@ namespace vt
 		std::filesystem::path script_dir_filepath = std::filesystem::path("assets") / "scripts";
 		std::filesystem::path theme_dir_filepath = "themes";
 		std::filesystem::path downloads_dir_filepath = "downloads";
+		std::filesystem::path cache_dir_filepath = "cache";
+		//Hashes and metadata of video files, shared by all projects
+		std::filesystem::path probe_cache_filepath = cache_dir_filepath / std::filesystem::path("files").replace_extension("json");
 		registry registry;
 		nlohmann::ordered_json settings;
 		window_config win_cfg;
@@ -133,6 +163,8 @@ namespace vt
 		utils::vec2<uint32_t>* gizmo_target{};
 
 		displayed_videos_manager displayed_videos;
+		video_stream_cache stream_cache;
+		video_probe_cache probe_cache;
 
 		widgets::insert_segment_data_container insert_segment_data;
 
@@ -180,6 +212,11 @@ namespace vt
 
 	private:
 		video_group_id_t current_video_group_id_{};
+		video_group_preload next_group_preload_;
+		utils::cancellation_token preload_token_;
+
+		//Starts opening the group that comes after the current one, the preload is dropped when the queue changes
+		void update_next_group_preload();
 	};
 
 	inline app_context ctx_;
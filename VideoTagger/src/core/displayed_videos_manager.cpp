@@ -1,5 +1,6 @@
 #include "pch.hpp"
 #include "displayed_videos_manager.hpp"
+#include "app_context.hpp"
 
 namespace vt
 {
@@ -9,7 +10,10 @@ namespace vt
 	}
 
 	displayed_video_data::displayed_video_data(displayed_video_data&& other) noexcept :
-		id{ other.id }, video{ std::move(other.video) }, offset{ other.offset }, display_texture{ std::move(other.display_texture) }
+		id{ other.id }, video{ std::move(other.video) }, offset{ other.offset }, display_texture{ std::move(other.display_texture) },
+		displayed_generation{ other.displayed_generation }, skipped_uploads{ other.skipped_uploads },
+		display_width_{ other.display_width_ }, display_height_{ other.display_height_ },
+		pending_generation_{ other.pending_generation_ }, upload_pending_{ other.upload_pending_ }
 	{
 		other.id = {};
 		other.offset = {};
@@ -25,6 +29,12 @@ namespace vt
 		video = std::move(other.video);
 		offset = other.offset;
 		display_texture = std::move(other.display_texture);
+		displayed_generation = other.displayed_generation;
+		skipped_uploads = other.skipped_uploads;
+		display_width_ = other.display_width_;
+		display_height_ = other.display_height_;
+		pending_generation_ = other.pending_generation_;
+		upload_pending_ = other.upload_pending_;
 
 		other.id = {};
 		other.offset = {};
@@ -37,12 +47,122 @@ namespace vt
 		return offset <= timestamp and timestamp <= offset + video.duration();
 	}
 
+	void displayed_video_data::update_texture()
+	{
+		prepare_texture();
+		upload_texture();
+	}
+
+	void displayed_video_data::prepare_texture()
+	{
+		auto generation = video.frame_generation();
+		if (generation == displayed_generation)
+		{
+			++skipped_uploads;
+			return;
+		}
+
+		video.prepare_frame(display_texture.width(), display_texture.height());
+		pending_generation_ = generation;
+		upload_pending_ = true;
+	}
+
+	void displayed_video_data::upload_texture()
+	{
+		if (!upload_pending_)
+		{
+			return;
+		}
+
+		video.upload_frame(display_texture);
+		displayed_generation = pending_generation_;
+		upload_pending_ = false;
+	}
+
+	void displayed_video_data::set_display_size(int width, int height)
+	{
+		display_width_ = width;
+		display_height_ = height;
+	}
+
+	void displayed_video_data::update_texture_size()
+	{
+		int video_width = video.width();
+		int video_height = video.height();
+		if (display_width_ <= 0 or display_height_ <= 0 or video_width <= 0 or video_height <= 0)
+		{
+			return;
+		}
+
+		// The widget keeps the aspect ratio, so the width is enough
+		int width = std::min((display_width_ + display_size_bucket - 1) / display_size_bucket * display_size_bucket, video_width);
+		int height = std::clamp(static_cast<int>(std::lround(static_cast<double>(width) * video_height / video_width)), 1, video_height);
+		if (width == display_texture.width() and height == display_texture.height())
+		{
+			return;
+		}
+
+		display_texture = gl_texture(width, height, GL_RGB);
+		video.get_frame(display_texture);
+		displayed_generation = video.frame_generation();
+		upload_pending_ = false;
+	}
+
+	template<typename function_t>
+	void displayed_videos_manager::for_each_video(function_t&& function)
+	{
+		// Not worth waking up a worker for a single video
+		// Videos are updated on interactive jobs, so a group costs about as much as its slowest video even while the background jobs run
+		if (videos_.size() > 1)
+		{
+			ctx_.jobs.parallel_for(videos_.size(), [this, &function](size_t index)
+			{
+				function(videos_[index]);
+			});
+		}
+		else
+		{
+			for (auto& video_data : videos_)
+			{
+				function(video_data);
+			}
+		}
+
+		// Textures can only be touched by the thread that owns the OpenGL context
+		for (auto& video_data : videos_)
+		{
+			video_data.upload_texture();
+		}
+	}
+
 	void displayed_videos_manager::update()
 	{
 		//TODO: maybe should do something to ensure that videos don't get desynchronized
 
+		// Done here so that inserting multiple videos doesn't reopen the decoders for each of them
+		if (!threads_distributed_)
+		{
+			distribute_threads();
+		}
+
+		// Applied here and not while drawing, so the texture isn't deleted while ImGui still uses it
+		for (auto& video_data : videos_)
+		{
+			video_data.update_texture_size();
+		}
+
 		if (!is_playing())
 		{
+			// Asynchronous seeks finish while paused too
+			bool seek_pending = std::any_of(videos_.begin(), videos_.end(), [](const displayed_video_data& video_data) { return video_data.video.seek_pending(); });
+			if (seek_pending)
+			{
+				for_each_video([](displayed_video_data& video_data)
+				{
+					video_data.video.poll_seek();
+					video_data.prepare_texture();
+				});
+			}
 			return;
 		}
 
@@ -58,7 +178,7 @@ namespace vt
 		current_timestamp_ += std::chrono::duration_cast<std::chrono::nanoseconds>((current_timepoint - last_timepoint_) * speed_);
 		last_timepoint_ = current_timepoint;
 
-		for (auto& video_data : videos_)
+		for_each_video([this](displayed_video_data& video_data)
 		{
 			bool timestamp_in_range = video_data.is_timestamp_in_range(current_timestamp_);
 			video_data.video.set_playing(timestamp_in_range);
@@ -66,14 +186,14 @@ namespace vt
 
 			if (timestamp_in_range)
 			{
-				video_data.video.get_frame(video_data.display_texture);
+				video_data.prepare_texture();
 			}
 			//else
 			//{
 			//	//TODO: Maybe should draw some icon or something, but then some other texture would need to be displayed since this texture can't be a render target
 			//	video_stream::clear_yuv_texture(video_data.display_texture, 0, 0, 0);
 			//}
-		}
+		});
 
 		auto group_duration = duration();
 		if (current_timestamp_ > group_duration)
@@ -111,12 +231,29 @@ namespace vt
 
 	void displayed_videos_manager::seek(std::chrono::nanoseconds timestamp)
 	{
-		std::for_each(std::execution::seq, videos_.begin(), videos_.end(), [timestamp, this](displayed_video_data& video_data)
+		seek_videos(timestamp, false);
+	}
+
+	void displayed_videos_manager::seek_async(std::chrono::nanoseconds timestamp)
+	{
+		seek_videos(timestamp, true);
+	}
+
+	void displayed_videos_manager::seek_videos(std::chrono::nanoseconds timestamp, bool async)
+	{
+		for_each_video([timestamp, async, this](displayed_video_data& video_data)
 		{
 			std::chrono::nanoseconds video_ts = timestamp - video_data.offset;
 			std::chrono::nanoseconds clamped_video_ts = std::clamp(video_ts, std::chrono::nanoseconds{ 0 }, video_data.video.duration());
-			video_data.video.seek(clamped_video_ts);
-			video_data.video.get_frame(video_data.display_texture);
+			if (async)
+			{
+				video_data.video.seek_async(clamped_video_ts);
+			}
+			else
+			{
+				video_data.video.seek(clamped_video_ts);
+			}
+			video_data.prepare_texture();
 
 			if (video_ts < std::chrono::nanoseconds{ 0 })
 			{
@@ -136,19 +273,71 @@ namespace vt
 		}
 	}
 
+	void displayed_videos_manager::set_thread_budget(int value)
+	{
+		thread_budget_ = std::max(value, 1);
+		threads_distributed_ = false;
+	}
+
+	void displayed_videos_manager::set_focused_video(std::optional<video_id_t> video_id)
+	{
+		if (focused_video_ == video_id)
+		{
+			return;
+		}
+
+		focused_video_ = video_id;
+		threads_distributed_ = false;
+	}
+
+	void displayed_videos_manager::set_scale_thread_override(std::optional<int> count)
+	{
+		if (count.has_value())
+		{
+			count = std::clamp(*count, 1, frame_converter::max_thread_count);
+		}
+
+		if (scale_thread_override_ == count)
+		{
+			return;
+		}
+
+		scale_thread_override_ = count;
+		threads_distributed_ = false;
+	}
+
+	void displayed_videos_manager::set_decode_mode(const decode_mode& mode)
+	{
+		if (decode_mode_ == mode)
+		{
+			return;
+		}
+
+		decode_mode_ = mode;
+		for_each_video([&mode](displayed_video_data& video_data)
+		{
+			video_data.video.set_decode_mode(mode);
+			video_data.prepare_texture();
+		});
+	}
+
 	std::pair<displayed_videos_manager::iterator, bool> displayed_videos_manager::insert(video_id_t id, video_stream&& video, std::chrono::nanoseconds offset, int video_width, int video_height, bool update)
 	{
+		video.set_decode_mode(decode_mode_, false);
+
 		if (auto it = find(id); it != end())
 		{
 			if (update)
 			{
 				*it = displayed_video_data(id, std::move(video), offset, video_width, video_height);
+				threads_distributed_ = false;
 			}
 			
 			return std::make_pair(it, false);
 		}
 
 		videos_.emplace_back(id, std::move(video), offset, video_width, video_height);
+		threads_distributed_ = false;
 		return std::make_pair(videos_.end() - 1, true);
 	}
 
@@ -161,12 +350,14 @@ namespace vt
 		}
 
 		videos_.erase(it);
+		threads_distributed_ = false;
 		return true;
 	}
 
 	displayed_videos_manager::iterator displayed_videos_manager::erase(const_iterator it)
 	{
 		auto result = videos_.erase(it);
+		threads_distributed_ = false;
 		if (empty())
 		{
 			current_timestamp_ = {};
@@ -181,6 +372,8 @@ namespace vt
 		current_timestamp_ = {};
 		is_playing_ = false;
 		videos_.clear();
+		// The threads reserved for the old decoders are released by the next update
+		threads_distributed_ = false;
 	}
 
 	displayed_videos_manager::iterator displayed_videos_manager::find(video_id_t video_id)
@@ -255,6 +448,105 @@ namespace vt
 		return return_value;
 	}
 
+	std::chrono::nanoseconds displayed_videos_manager::frame_step_timestamp(std::chrono::nanoseconds timestamp, int frames) const
+	{
+		const displayed_video_data* reference = nullptr;
+		for (auto& video_data : videos_)
+		{
+			if (!video_data.is_timestamp_in_range(timestamp))
+			{
+				continue;
+			}
+
+			if (reference == nullptr or reference->video.fps() < video_data.video.fps())
+			{
+				reference = &video_data;
+			}
+		}
+
+		if (reference == nullptr)
+		{
+			if (videos_.empty())
+			{
+				return timestamp;
+			}
+
+			return timestamp + std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(frames / max_framerate()));
+		}
+
+		auto& video = reference->video;
+		int64_t frame_number = static_cast<int64_t>(video.timestamp_to_frame_number(timestamp - reference->offset)) + frames;
+		return reference->offset + video.frame_number_to_timestamp(static_cast<size_t>(std::max<int64_t>(frame_number, 0)));
+	}
+
+	int displayed_videos_manager::thread_budget() const
+	{
+		return thread_budget_;
+	}
+
+	const decode_mode& displayed_videos_manager::get_decode_mode() const
+	{
+		return decode_mode_;
+	}
+
+	int displayed_videos_manager::default_thread_budget()
+	{
+		// One core is left for the main thread
+		int hardware_threads = static_cast<int>(std::thread::hardware_concurrency());
+		return std::max(hardware_threads - 1, 1);
+	}
+
+	void displayed_videos_manager::distribute_threads()
+	{
+		threads_distributed_ = true;
+		if (videos_.empty())
+		{
+			ctx_.jobs.set_reserved_threads(0);
+			return;
+		}
+
+		bool has_focused_video = focused_video_.has_value() and contains(*focused_video_);
+
+		// Every video has a pipeline thread, with one codec thread and one scale thread it also decodes and converts the frames itself
+		// That's the least a video can use, what's left of the budget is split into shares and the focused video gets two of them
+		int video_count = static_cast<int>(videos_.size());
+		int extra_threads = std::max(thread_budget_ - video_count, 0);
+		int share_count = video_count + (has_focused_video ? 1 : 0);
+		int share = extra_threads / share_count;
+		int remainder = extra_threads - share * share_count;
+
+		int used_threads{};
+		for (auto& video_data : videos_)
+		{
+			bool focused = has_focused_video and video_data.id == *focused_video_;
+			int spare_threads = share * (focused ? 2 : 1);
+			if (focused or (!has_focused_video and remainder > 0))
+			{
+				spare_threads += remainder;
+				remainder = 0;
+			}
+
+			// More than one codec or scale thread means that many threads are started besides the pipeline thread,
+			// decoding is the most expensive part, so scaling only gets threads when there are plenty
+			int scale_threads = spare_threads >= 6 ? std::min(spare_threads / 3, frame_converter::max_thread_count) : 1;
+			if (scale_thread_override_.has_value())
+			{
+				scale_threads = *scale_thread_override_;
+			}
+			if (scale_threads > 1)
+			{
+				spare_threads -= scale_threads;
+			}
+			int codec_threads = spare_threads >= 2 ? std::min(spare_threads, max_threads_per_video) : 1;
+
+			video_data.video.set_decode_thread_count(codec_threads);
+			video_data.video.set_scale_thread_count(scale_threads);
+			used_threads += 1 + (codec_threads > 1 ? codec_threads : 0) + (scale_threads > 1 ? scale_threads : 0);
+		}
+
+		ctx_.jobs.set_reserved_threads(static_cast<size_t>(used_threads));
+	}
+
 	displayed_videos_manager::iterator displayed_videos_manager::begin()
 	{
 		return videos_.begin();
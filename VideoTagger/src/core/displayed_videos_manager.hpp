@@ -1,5 +1,6 @@
 #pragma once
 #include <chrono>
+#include <optional>
 #include <vector>
 
 #include <video/video_pool.hpp>
@@ -9,6 +10,9 @@ namespace vt
 {
 	struct displayed_video_data
 	{
+		//The display texture width is rounded up to a multiple of this, so resizing the widget doesn't recreate it every frame
+		static constexpr int display_size_bucket = 128;
+
 		displayed_video_data(video_id_t id, video_stream&& video, std::chrono::nanoseconds offset, int video_width, int video_height);
 		displayed_video_data(const displayed_video_data&) = delete;
 		displayed_video_data(displayed_video_data&&) noexcept;
@@ -22,8 +26,28 @@ namespace vt
 		std::chrono::nanoseconds offset{};
 
 		gl_texture display_texture;
+		//Frame generation of the video that is in display_texture
+		uint64_t displayed_generation{};
+		//Updates that didn't have to convert and upload anything because the frame didn't change
+		uint64_t skipped_uploads{};
 
 		bool is_timestamp_in_range(std::chrono::nanoseconds timestamp) const;
+		//Converts and uploads the current frame only if it changed since the last upload
+		void update_texture();
+		//CPU part of update_texture, safe to call from a worker thread
+		void prepare_texture();
+		//OpenGL part of update_texture, has to be called on the render thread
+		void upload_texture();
+		//Size of the image on screen, the texture is resized on the next update, it's never bigger than the video
+		void set_display_size(int width, int height);
+		//Recreates the texture if the display size moved to a different bucket
+		void update_texture_size();
+
+	private:
+		int display_width_{};
+		int display_height_{};
+		uint64_t pending_generation_{};
+		bool upload_pending_{};
 	};
 
 	class displayed_videos_manager
@@ -38,6 +62,19 @@ namespace vt
 		void set_playing(bool value);
 		void set_speed(float value);
 		void seek(std::chrono::nanoseconds timestamp);
+		//Used while scrubbing, returns right away and shows the nearest available frames until the exact ones are decoded
+		void seek_async(std::chrono::nanoseconds timestamp);
+
+		//Total number of threads used by the pipelines, decoders and converters of all videos, the threads they use are also reserved in ctx_.jobs
+		//Each video always has its pipeline thread, in a group with more videos than the budget every video decodes and converts on that thread alone
+		void set_thread_budget(int value);
+		//The focused video gets a bigger share of the thread budget
+		void set_focused_video(std::optional<video_id_t> video_id);
+		//Every video converts its frames with this many threads instead of its share of the budget, used to compare whole frame and sliced conversion
+		void set_scale_thread_override(std::optional<int> count);
+
+		//Used while scrubbing, the current frames are decoded again when the mode changes
+		void set_decode_mode(const decode_mode& mode);
 
 		//if update is true and a video with id is already present the video data will be updated
 		std::pair<iterator, bool> insert(video_id_t id, video_stream&& video, std::chrono::nanoseconds offset, int video_width, int video_height, bool update = true);
@@ -56,6 +93,10 @@ namespace vt
 		size_t size() const;
 		bool empty() const;
 		double max_framerate() const;
+		int thread_budget() const;
+		const decode_mode& get_decode_mode() const;
+		//Returns the timestamp of the frame that is the given number of frames away, the video with the highest framerate is used as reference
+		std::chrono::nanoseconds frame_step_timestamp(std::chrono::nanoseconds timestamp, int frames) const;
 	
 		iterator begin();
 		const_iterator begin() const;
@@ -64,13 +105,29 @@ namespace vt
 		const_iterator end() const;
 		const_iterator cend() const;
 
+		static int default_thread_budget();
+
 	private:
+		static constexpr int max_threads_per_video = 16;
+
 		container videos_;
 		
 		bool is_playing_{};
 		float speed_{1};
 
+		int thread_budget_ = default_thread_budget();
+		std::optional<video_id_t> focused_video_;
+		std::optional<int> scale_thread_override_;
+		bool threads_distributed_ = true;
+		decode_mode decode_mode_;
+
 		std::chrono::nanoseconds current_timestamp_{};
 		std::chrono::steady_clock::time_point last_timepoint_;
+
+		void distribute_threads();
+		void seek_videos(std::chrono::nanoseconds timestamp, bool async);
+		//Runs the function for every video on the worker pool and waits for all of them, then uploads the prepared textures
+		template<typename function_t>
+		void for_each_video(function_t&& function);
 	};
 }
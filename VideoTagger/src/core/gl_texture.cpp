@@ -31,6 +31,7 @@ namespace vt
 		width_ = other.width_;
 		height_ = other.height_;
 		id_ = other.id_;
+		format_ = other.format_;
 
 		other.id_ = 0;
 
@@ -65,10 +66,22 @@ namespace vt
 		return format_;
 	}
 
-	void gl_texture::set_pixels(void* pixels)
+	void gl_texture::set_pixels(void* pixels, GLint row_length)
 	{
 		glBindTexture(GL_TEXTURE_2D, id_);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, row_length);
 		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width_, height_, format_, GL_UNSIGNED_BYTE, pixels);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	void gl_texture::set_pixels(GLint x, GLint y, GLsizei width, GLsizei height, const void* pixels, GLint row_length)
+	{
+		glBindTexture(GL_TEXTURE_2D, id_);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, row_length);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, format_, GL_UNSIGNED_BYTE, pixels);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
 		glBindTexture(GL_TEXTURE_2D, 0);
 	}
 }
@@ -21,7 +21,10 @@ namespace vt
 		GLsizei height() const;
 		GLenum format() const;
 
-		void set_pixels(void* pixels);
+		//row_length is the distance between rows in pixels, 0 if the rows are tightly packed
+		void set_pixels(void* pixels, GLint row_length = 0);
+		//Updates only the given region of the texture
+		void set_pixels(GLint x, GLint y, GLsizei width, GLsizei height, const void* pixels, GLint row_length = 0);
 
 	private:
 		GLuint id_;
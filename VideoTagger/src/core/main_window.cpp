@@ -104,6 +104,7 @@ namespace vt
 				return;
 			}
 			ctx_.current_project = project::load_from_file(project_info.path);
+			ctx_.current_project->thumbnails.set_budget(static_cast<size_t>(ctx_.app_settings.thumbnail_memory_budget) * 1024 * 1024);
 			ctx_.main_window->set_subtitle(ctx_.current_project->name);
 			ctx_.console.clear();
 		};
@@ -125,6 +126,7 @@ namespace vt
 
 		init_options();
 		load_settings();
+		ctx_.probe_cache.load(ctx_.probe_cache_filepath);
 		init_keybinds();
 		init_player();
 		fetch_themes();
@@ -142,14 +144,6 @@ namespace vt
 			return false;
 		}
 
-		if (ctx_.current_project.has_value())
-		{
-			for (auto& download_task : ctx_.current_project->video_download_tasks)
-			{
-				download_task.task.cancel();
-			}
-		}
-
 		ctx_.gizmo_target = nullptr;
 		ctx_.last_focused_video = std::nullopt;
 		ctx_.registry.execute<set_selected_attribute_command>(nullptr);
@@ -170,6 +164,11 @@ namespace vt
 			save_settings();
 		}
 
+		if (!ctx_.probe_cache.save(ctx_.probe_cache_filepath))
+		{
+			debug::warn("Failed to save the file cache to {}", ctx_.probe_cache_filepath.u8string());
+		}
+
 		if (ctx_.current_project.has_value() and ctx_.is_project_dirty)
 		{
 			const SDL_MessageBoxButtonData buttons[] = {
@@ -200,6 +199,13 @@ namespace vt
 				case 0: return false;
 			}
 		}
+
+		// Nothing would pick up the results, running downloads keep their videos until they stop
+		if (ctx_.current_project.has_value())
+		{
+			ctx_.current_project->cancel_jobs();
+		}
+
 		if (should_shutdown) ctx_.state_ = app_state::shutdown;
 		return true;
 	}
@@ -340,6 +346,31 @@ namespace vt
 			{
 				ctx_.app_settings.load_thumbnails = ctx_.settings.at("load-thumbnails");
 			}
+			if (ctx_.settings.contains("thumbnail-memory-budget"))
+			{
+				ctx_.app_settings.thumbnail_memory_budget = ctx_.settings.at("thumbnail-memory-budget");
+			}
+			if (ctx_.settings.contains("frame-cache-size"))
+			{
+				ctx_.app_settings.frame_cache_size = ctx_.settings.at("frame-cache-size");
+			}
+			if (ctx_.settings.contains("warm-video-cache-size"))
+			{
+				ctx_.app_settings.warm_video_cache_size = ctx_.settings.at("warm-video-cache-size");
+				ctx_.stream_cache.set_limit(static_cast<size_t>(ctx_.app_settings.warm_video_cache_size));
+			}
+			if (ctx_.settings.contains("generate-proxies"))
+			{
+				ctx_.app_settings.generate_proxies = ctx_.settings.at("generate-proxies");
+			}
+			if (ctx_.settings.contains("proxy-height"))
+			{
+				ctx_.app_settings.proxy_height = ctx_.settings.at("proxy-height");
+			}
+			if (ctx_.settings.contains("show-filmstrip"))
+			{
+				ctx_.app_settings.show_filmstrip = ctx_.settings.at("show-filmstrip");
+			}
 			if (ctx_.settings.contains("autoplay"))
 			{
 				ctx_.app_settings.autoplay = ctx_.settings.at("autoplay");
@@ -406,6 +437,8 @@ namespace vt
 		if (on_close_project(false))
 		{
 			ctx_.reset_current_video_group();
+			// Video ids are only unique within a project
+			ctx_.stream_cache.clear();
 			ctx_.current_project = std::nullopt;
 			ctx_.video_timeline.selected_segment = std::nullopt;
 			ctx_.is_project_dirty = false;
@@ -766,6 +799,91 @@ namespace vt
 				ctx_.settings["load-thumbnails"] = ctx_.app_settings.load_thumbnails;
 			}
 
+			ImGui::AlignTextToFramePadding();
+			ImGui::TextUnformatted("Thumbnail Memory Budget (MB)");
+			ImGui::SameLine();
+			ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x / 4);
+			if (ImGui::DragInt("##ThumbnailMemoryBudgetDrag", &ctx_.app_settings.thumbnail_memory_budget, 1.0f, 16, 4096, "%d", ImGuiSliderFlags_AlwaysClamp))
+			{
+				ctx_.settings["thumbnail-memory-budget"] = ctx_.app_settings.thumbnail_memory_budget;
+				if (ctx_.current_project.has_value())
+				{
+					ctx_.current_project->thumbnails.set_budget(static_cast<size_t>(ctx_.app_settings.thumbnail_memory_budget) * 1024 * 1024);
+				}
+			}
+			if (ctx_.current_project.has_value())
+			{
+				auto stats = ctx_.current_project->thumbnails.stats();
+				ImGui::SameLine();
+				ImGui::TextDisabled("%zu MB in %zu pages, %zu/%zu slots used", stats.resident_bytes / (1024 * 1024), stats.page_count, stats.tile_count, stats.slot_count);
+			}
+
+			{
+				auto stats = ctx_.jobs.stats();
+				auto interactive = static_cast<size_t>(utils::job_priority::interactive);
+				auto import = static_cast<size_t>(utils::job_priority::import);
+				auto background = static_cast<size_t>(utils::job_priority::background);
+
+				ImGui::AlignTextToFramePadding();
+				ImGui::TextUnformatted("Background Jobs");
+				ImGui::SameLine();
+				ImGui::TextDisabled("%zu threads, running %zu/%zu/%zu, waiting %zu/%zu/%zu (interactive/import/background)", stats.thread_count,
+					stats.running[interactive], stats.running[import], stats.running[background], stats.pending[interactive], stats.pending[import], stats.pending[background]);
+				for (float progress : stats.progress)
+				{
+					ImGui::SameLine();
+					ImGui::TextDisabled("%.0f%%", progress * 100.0f);
+				}
+			}
+
+			ImGui::AlignTextToFramePadding();
+			ImGui::TextUnformatted("Frame Cache Size (MB)");
+			ImGui::SameLine();
+			ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x / 4);
+			if (ImGui::DragInt("##FrameCacheSizeDrag", &ctx_.app_settings.frame_cache_size, 1.0f, 0, 8192, "%d", ImGuiSliderFlags_AlwaysClamp))
+			{
+				ctx_.settings["frame-cache-size"] = ctx_.app_settings.frame_cache_size;
+				for (auto& video_data : ctx_.displayed_videos)
+				{
+					video_data.video.set_frame_cache_budget(static_cast<size_t>(ctx_.app_settings.frame_cache_size) * 1024 * 1024);
+				}
+			}
+
+			ImGui::AlignTextToFramePadding();
+			ImGui::TextUnformatted("Warm Video Cache Size");
+			ImGui::SameLine();
+			ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x / 4);
+			if (ImGui::DragInt("##WarmVideoCacheSizeDrag", &ctx_.app_settings.warm_video_cache_size, 0.1f, 0, 32, "%d", ImGuiSliderFlags_AlwaysClamp))
+			{
+				ctx_.settings["warm-video-cache-size"] = ctx_.app_settings.warm_video_cache_size;
+				ctx_.stream_cache.set_limit(static_cast<size_t>(ctx_.app_settings.warm_video_cache_size));
+			}
+
+			ImGui::AlignTextToFramePadding();
+			ImGui::TextUnformatted("Generate Proxies");
+			ImGui::SameLine();
+			if (ImGui::Checkbox("##GenerateProxiesCheckbox", &ctx_.app_settings.generate_proxies))
+			{
+				ctx_.settings["generate-proxies"] = ctx_.app_settings.generate_proxies;
+			}
+
+			ImGui::AlignTextToFramePadding();
+			ImGui::TextUnformatted("Proxy Height");
+			ImGui::SameLine();
+			ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x / 4);
+			if (ImGui::DragInt("##ProxyHeightDrag", &ctx_.app_settings.proxy_height, 1.0f, 144, 1080, "%d", ImGuiSliderFlags_AlwaysClamp))
+			{
+				ctx_.settings["proxy-height"] = ctx_.app_settings.proxy_height;
+			}
+
+			ImGui::AlignTextToFramePadding();
+			ImGui::TextUnformatted("Show Timeline Filmstrip");
+			ImGui::SameLine();
+			if (ImGui::Checkbox("##ShowFilmstripCheckbox", &ctx_.app_settings.show_filmstrip))
+			{
+				ctx_.settings["show-filmstrip"] = ctx_.app_settings.show_filmstrip;
+			}
+
 			//TODO: Add theme selection
 
 #ifdef _DEBUG
@@ -981,7 +1099,15 @@ namespace vt
 			{
 				return;
 			}
-			ctx_.displayed_videos.seek(ts);
+
+			if (ctx_.player.is_scrubbing())
+			{
+				ctx_.displayed_videos.seek_async(ts);
+			}
+			else
+			{
+				ctx_.displayed_videos.seek(ts);
+			}
 		};
 
 		ctx_.player.callbacks.on_finish = [](loop_mode mode, bool is_playing)
@@ -1640,106 +1766,10 @@ namespace vt
 		}
 
 		{
-			auto& tasks = ctx_.current_project->video_import_tasks;
-			for (auto it = tasks.begin(); it != tasks.end();)
-			{
-				auto& task = *it;
-				if (task.task.wait_for(std::chrono::seconds{}) != std::future_status::ready)
-				{
-					++it;
-					continue;
-				}
-
-				auto vid_resource = task.task.get();
-				if (vid_resource != nullptr)
-				{
-					video_id_t video_id = vid_resource->id();
-					if (ctx_.current_project->import_video(std::move(vid_resource), task.group_id))
-					{
-						if (ctx_.app_settings.load_thumbnails)
-						{
-							ctx_.current_project->schedule_generate_thumbnail(video_id);
-						}
-					}
-				}
-				it = tasks.erase(it);
-			}
-		}
-
-		{
-			auto& tasks = ctx_.current_project->generate_thumbnail_tasks;
-			for (auto it = tasks.begin(); it != tasks.end();)
-			{
-				auto& task = *it;
-				if (!task())
-				{
-					debug::error("Failed to generate thumbnail");
-				}
-
-				it = tasks.erase(it);
-				//TODO: set some frame time limit;
-				break;
-			}
-		}
-
-		{
-			auto& tasks = ctx_.current_project->video_download_tasks;
-			for (auto it = tasks.begin(); it != tasks.end();)
-			{
-				auto& task = *it;
-				if (!task.task.is_done())
-				{
-					++it;
-					continue;
-				}
-
-				std::string video_name = "NAME_UNKNOWN";
-				if (ctx_.current_project->videos.contains(task.video_id))
-				{
-					video_name = ctx_.current_project->videos.get(task.video_id).metadata().title.value_or(video_name);
-				}
-
-				auto status = task.task.result.get();
-				if (status == video_download_status::failure)
-				{
-					debug::error("Failed to download video {} ({})", video_name, task.video_id);
-					ctx_.console.add_entry(widgets::console::entry::flag_type::error, fmt::format("Failed to download video {} ({})", video_name, task.video_id), widgets::console::entry::source_info{ "VideoTagger", -1 });
-				}
-				else
-				{
-					debug::log("Downloaded video {} ({})", video_name, task.video_id);
-					dynamic_cast<downloadable_video_resource&>(ctx_.current_project->videos.get(task.video_id)).set_file_path(task.task.data->download_path.u8string());
-					ctx_.console.add_entry(widgets::console::entry::flag_type::info, fmt::format("Downloaded video {} ({})", video_name, task.video_id), widgets::console::entry::source_info{ "VideoTagger", -1 });
-				}
-
-				it = tasks.erase(it);
-			}
-		}
-
-		{
-			auto& tasks = ctx_.current_project->video_refresh_tasks;
-			for (auto it = tasks.begin(); it != tasks.end();)
-			{
-				auto& task = *it;
-				if (task.task.wait_for(std::chrono::seconds{}) != std::future_status::ready)
-				{
-					++it;
-					continue;
-				}
-
-				it = tasks.erase(it);
-			}
-		}
-
-		{
-			auto& tasks = ctx_.current_project->remove_video_tasks;
-			for (auto it = tasks.begin(); it != tasks.end();)
-			{
-				auto& task = *it;
-				task.task.get();
-
-				it = tasks.erase(it);
-			}
+			// The jobs run on ctx_.jobs, only their completions are limited, so uploading many thumbnails doesn't stall the frame
+			static constexpr auto completion_budget = std::chrono::milliseconds{ 2 };
+			ctx_.jobs.dispatch_completions(completion_budget);
+			ctx_.current_project->thumbnails.next_frame();
 		}
 
 		handle_insert_segment();
@@ -1842,7 +1872,7 @@ namespace vt
 					point_pos = { (float)ctx_.gizmo_target->at(0), (float)ctx_.gizmo_target->at(1) };
 				}
 
-				widgets::draw_video_widget(video_data.video, video_data.display_texture, timestamp_in_range, is_widget_open, vid_id++, [&point_pos, has_selected_attribute, selected_attribute, is_shape, has_target, &video_data, &selected_segment](ImVec2 pos, ImVec2 size, ImVec2 tex_size)
+				auto image_size = widgets::draw_video_widget(video_data.video, video_data.display_texture, timestamp_in_range, is_widget_open, vid_id++, [&point_pos, has_selected_attribute, selected_attribute, is_shape, has_target, &video_data, &selected_segment](ImVec2 pos, ImVec2 size, ImVec2 tex_size)
 				{
 					static constexpr auto orange = tag_attribute::type_color(tag_attribute::type::shape); //0xFF30A0F0;
 					static auto from_tex_pos = [&pos, &tex_size, &size](const ImVec2 point) -> ImVec2
@@ -2276,6 +2306,7 @@ namespace vt
 					//auto local_pos = from_tex_pos(point_pos);
 					//draw_list->AddCircle(local_pos, 10.f, border_color);
 				});
+				video_data.set_display_size(static_cast<int>(image_size.x), static_cast<int>(image_size.y));
 			}
 		}
 
@@ -2303,10 +2334,20 @@ namespace vt
 			ctx_.video_timeline.insert_segment_container = &ctx_.insert_segment_data;
 
 			ctx_.video_timeline.render(ctx_.win_cfg.show_timeline_window);
+			bool is_scrubbing = ctx_.video_timeline.is_scrubbing() or ctx_.player.is_scrubbing();
+			ctx_.displayed_videos.set_decode_mode(is_scrubbing ? decode_mode::preview() : decode_mode::full());
 
 			if (ctx_.video_timeline.current_timestamp().total_milliseconds != std::chrono::duration_cast<std::chrono::milliseconds>(ctx_.displayed_videos.current_timestamp()))
 			{
-				ctx_.displayed_videos.seek(ctx_.video_timeline.current_timestamp().total_milliseconds);
+				// Doesn't block the frame while dragging, the exact frames show up when they are decoded
+				if (ctx_.video_timeline.is_scrubbing())
+				{
+					ctx_.displayed_videos.seek_async(ctx_.video_timeline.current_timestamp().total_milliseconds);
+				}
+				else
+				{
+					ctx_.displayed_videos.seek(ctx_.video_timeline.current_timestamp().total_milliseconds);
+				}
 			}
 		}
 
@@ -88,11 +88,6 @@ namespace vt
 		return task(import_data);
 	}
 
-	bool generate_thumbnail_task::operator()()
-	{
-		return task();
-	}
-
 	void project::prepare_video_import(const std::string& importer_id)
 	{
 		if (!ctx_.is_video_importer_registered(importer_id))
@@ -116,21 +111,55 @@ namespace vt
 			return;
 		}
 
+		// The imported video and the existing videos with the same fingerprint, compared on the job so the main thread doesn't read the files
+		using import_result = std::pair<std::unique_ptr<video_resource>, std::vector<video_id_t>>;
+
 		auto& importer = ctx_.get_video_importer(importer_id);
-		video_import_task task;
-		task.group_id = group_id;
-		auto func = [&importer, import_data = std::move(import_data)]()
+		auto import_task = [&importer, import_data = std::move(import_data), video_files = video_files()]()
 		{
-			return importer.import_video(video_importer::generate_video_id(), std::move(import_data));
+			import_result result;
+			result.first = importer.import_video(video_importer::generate_video_id(), std::move(import_data));
+			if (result.first != nullptr)
+			{
+				result.second = find_matching_fingerprints(*result.first, video_files);
+			}
+			return result;
 		};
 
-		task.task = std::async(std::launch::async, func);
-		video_import_tasks.push_back(std::move(task));
+		ctx_.jobs.submit(utils::job_priority::import, std::move(import_task), [group_id](import_result result)
+		{
+			auto& [vid_resource, matching_fingerprints] = result;
+			if (vid_resource == nullptr)
+			{
+				return;
+			}
+
+			auto& project = *ctx_.current_project;
+			video_id_t video_id = vid_resource->id();
+			if (!project.import_video(std::move(vid_resource), group_id, true, true, std::move(matching_fingerprints)))
+			{
+				return;
+			}
+
+			if (ctx_.app_settings.load_thumbnails)
+			{
+				project.schedule_generate_thumbnail(video_id, utils::job_priority::import);
+			}
+			// Otherwise they are scheduled when the hash is done, because they are cached by it
+			if (project.videos.get(video_id).metadata().sha256.has_value())
+			{
+				project.schedule_build_frame_index(video_id);
+				if (ctx_.app_settings.generate_proxies)
+				{
+					project.schedule_generate_proxy(video_id);
+				}
+			}
+		}, job_token);
 	}
 
 	void project::schedule_video_download(video_id_t video_id)
 	{
-		if (!videos.contains(video_id))
+		if (!videos.contains(video_id) or has_video_job(video_id, video_job_type::download))
 		{
 			return;
 		}
@@ -141,29 +170,193 @@ namespace vt
 			return;
 		}
 
-		video_download_task task;
-		task.video_id = video_id;
-		task.task = vid_resource->download_task();
+		auto& job = add_video_job(video_id, video_job_type::download);
+		job.resource_mutex = std::make_shared<std::mutex>();
+		auto task = vid_resource->download_task(job.token);
+
+		auto download_task = [function = std::move(task.function), mutex = job.resource_mutex, token = job.token]()
+		{
+			std::unique_lock lock(*mutex);
+			if (token.is_cancelled())
+			{
+				return video_download_status::failure;
+			}
+
+			// A value-initialized status would be a success, so the error is turned into a failure here
+			try
+			{
+				return function();
+			}
+			catch (const std::exception& ex)
+			{
+				debug::error("Download failed: {}", ex.what());
+				return video_download_status::failure;
+			}
+		};
+
+		ctx_.jobs.submit(utils::job_priority::import, std::move(download_task), [video_id, data = task.data](video_download_status status)
+		{
+			auto& project = *ctx_.current_project;
+			project.end_video_job(video_id, video_job_type::download);
 
-		video_download_tasks.push_back(std::move(task));
+			std::string video_name = "NAME_UNKNOWN";
+			if (project.videos.contains(video_id))
+			{
+				video_name = project.videos.get(video_id).metadata().title.value_or(video_name);
+			}
+
+			if (status == video_download_status::failure)
+			{
+				debug::error("Failed to download video {} ({})", video_name, video_id);
+				ctx_.console.add_entry(widgets::console::entry::flag_type::error, fmt::format("Failed to download video {} ({})", video_name, video_id), widgets::console::entry::source_info{ "VideoTagger", -1 });
+				return;
+			}
+
+			debug::log("Downloaded video {} ({})", video_name, video_id);
+			dynamic_cast<downloadable_video_resource&>(project.videos.get(video_id)).set_file_path(data->download_path.u8string());
+			project.schedule_build_frame_index(video_id);
+			if (ctx_.app_settings.generate_proxies)
+			{
+				project.schedule_generate_proxy(video_id);
+			}
+			ctx_.console.add_entry(widgets::console::entry::flag_type::info, fmt::format("Downloaded video {} ({})", video_name, video_id), widgets::console::entry::source_info{ "VideoTagger", -1 });
+		}, job.token);
 	}
 
-	void project::schedule_generate_thumbnail(video_id_t video_id)
+	//Uploads the thumbnail made by a job of schedule_generate_thumbnail or request_thumbnail
+	static void on_thumbnail_done(video_id_t video_id, std::optional<thumbnail_image> image)
 	{
-		if (!videos.contains(video_id))
+		auto& project = *ctx_.current_project;
+		project.end_video_job(video_id, video_job_type::thumbnail);
+
+		if (!image.has_value())
+		{
+			debug::error("Failed to generate thumbnail");
+			project.failed_thumbnails.insert(video_id);
+		}
+		else if (project.videos.contains(video_id))
+		{
+			project.thumbnails.insert(video_id, *image);
+		}
+	}
+
+	void project::schedule_generate_thumbnail(video_id_t video_id, utils::job_priority priority)
+	{
+		if (!videos.contains(video_id) or has_video_job(video_id, video_job_type::thumbnail))
 		{
 			return;
 		}
 
-		generate_thumbnail_task task;
-		task.task = videos.get(video_id).update_thumbnail_task();
-		task.video_id = video_id;
-		generate_thumbnail_tasks.push_back(std::move(task));
+		failed_thumbnails.erase(video_id);
+
+		auto task = videos.get(video_id).update_thumbnail_task();
+		if (task == nullptr)
+		{
+			return;
+		}
+
+		auto& job = add_video_job(video_id, video_job_type::thumbnail);
+		ctx_.jobs.submit(priority, std::move(task), [video_id](std::optional<thumbnail_image> image)
+		{
+			on_thumbnail_done(video_id, std::move(image));
+		}, job.token);
+	}
+
+	void project::schedule_check_thumbnails()
+	{
+		std::vector<std::pair<video_id_t, std::filesystem::path>> paths;
+		for (auto& [id, video] : videos)
+		{
+			paths.emplace_back(id, video->thumbnail_cache_path());
+		}
+
+		if (paths.empty())
+		{
+			return;
+		}
+
+		struct check_result
+		{
+			std::vector<std::pair<video_id_t, thumbnail_image>> loaded;
+			std::vector<video_id_t> missing;
+		};
+
+		// The cached thumbnails are read in one batch, but only as many are decoded as fit in the atlas, the rest are read by request_thumbnail
+		auto check_task = [paths = std::move(paths), capacity = thumbnails.capacity()]()
+		{
+			check_result result;
+			for (auto& [video_id, path] : paths)
+			{
+				std::error_code ec;
+				if (path.empty() or !std::filesystem::is_regular_file(path, ec))
+				{
+					result.missing.push_back(video_id);
+					continue;
+				}
+
+				if (result.loaded.size() >= capacity)
+				{
+					continue;
+				}
+
+				auto image = decode_thumbnail_data(load_thumbnail_data(path));
+				if (!image.has_value())
+				{
+					result.missing.push_back(video_id);
+					continue;
+				}
+				result.loaded.emplace_back(video_id, std::move(*image));
+			}
+			return result;
+		};
+
+		ctx_.jobs.submit(utils::job_priority::background, std::move(check_task), [](check_result result)
+		{
+			auto& project = *ctx_.current_project;
+			for (auto& [video_id, image] : result.loaded)
+			{
+				// Tiles that were already requested when they became visible are uploaded by their own jobs
+				if (project.videos.contains(video_id) and !project.thumbnails.contains(video_id) and !project.has_video_job(video_id, video_job_type::thumbnail))
+				{
+					project.thumbnails.insert(video_id, image);
+				}
+			}
+
+			for (auto video_id : result.missing)
+			{
+				project.schedule_generate_thumbnail(video_id);
+			}
+		}, job_token);
+	}
+
+	void project::request_thumbnail(video_id_t video_id)
+	{
+		if (!ctx_.app_settings.load_thumbnails or !videos.contains(video_id) or thumbnails.contains(video_id) or failed_thumbnails.count(video_id) != 0 or has_video_job(video_id, video_job_type::thumbnail))
+		{
+			return;
+		}
+
+		auto path = videos.get(video_id).thumbnail_cache_path();
+		std::error_code ec;
+		if (path.empty() or !std::filesystem::is_regular_file(path, ec))
+		{
+			schedule_generate_thumbnail(video_id, utils::job_priority::interactive);
+			return;
+		}
+
+		auto& job = add_video_job(video_id, video_job_type::thumbnail);
+		ctx_.jobs.submit(utils::job_priority::interactive, [path = std::move(path)]()
+		{
+			return decode_thumbnail_data(load_thumbnail_data(path));
+		}, [video_id](std::optional<thumbnail_image> image)
+		{
+			on_thumbnail_done(video_id, std::move(image));
+		}, job.token);
 	}
 
 	void project::schedule_video_refresh(video_id_t video_id)
 	{
-		if (!videos.contains(video_id))
+		if (!videos.contains(video_id) or has_video_job(video_id, video_job_type::refresh))
 		{
 			return;
 		}
@@ -174,10 +367,11 @@ namespace vt
 			return;
 		}
 
-		video_refresh_task task;
-		task.task = std::async(std::launch::async, refresh_task);
-		task.video_id = video_id;
-		video_refresh_tasks.push_back(std::move(task));
+		auto& job = add_video_job(video_id, video_job_type::refresh);
+		ctx_.jobs.submit(utils::job_priority::import, std::move(refresh_task), [video_id]()
+		{
+			ctx_.current_project->end_video_job(video_id, video_job_type::refresh);
+		}, job.token);
 	}
 
 	void project::schedule_remove_video(video_id_t video_id)
@@ -187,18 +381,405 @@ namespace vt
 			return;
 		}
 
-		auto remove_task = [this, video_id]()
+		// Removed between frames, so nothing that is being drawn refers to it
+		ctx_.jobs.post([video_id]()
+		{
+			ctx_.current_project->remove_video(video_id);
+		}, job_token);
+	}
+
+	void project::schedule_build_frame_index(video_id_t video_id)
+	{
+		if (!videos.contains(video_id) or has_video_job(video_id, video_job_type::frame_index))
+		{
+			return;
+		}
+
+		auto& vid_resource = videos.get(video_id);
+		if (!vid_resource.playable() or vid_resource.get_frame_index() != nullptr)
+		{
+			return;
+		}
+
+		auto& job = add_video_job(video_id, video_job_type::frame_index);
+		auto build_task = [video_path = std::filesystem::path(vid_resource.file_path()), cache_path = vid_resource.cache_path("frame-index", frame_index::extension), token = job.token]() -> std::shared_ptr<const frame_index>
 		{
-			remove_video(video_id);
+			if (!cache_path.empty())
+			{
+				auto index = frame_index::load(cache_path);
+				if (index.has_value())
+				{
+					return std::make_shared<const frame_index>(std::move(*index));
+				}
+			}
+
+			auto index = frame_index::build(video_path, token);
+			if (token.is_cancelled())
+			{
+				return nullptr;
+			}
+
+			if (!index.has_value())
+			{
+				debug::warn("Failed to build frame index for {}", video_path.u8string());
+				return nullptr;
+			}
+
+			if (!cache_path.empty() and !index->save(cache_path))
+			{
+				debug::warn("Failed to save frame index to {}", cache_path.u8string());
+			}
+
+			return std::make_shared<const frame_index>(std::move(*index));
 		};
 
-		remove_video_task task;
-		task.task = std::async(std::launch::deferred, remove_task);
-		task.video_id = video_id;
-		remove_video_tasks.push_back(std::move(task));
+		ctx_.jobs.submit(utils::job_priority::background, std::move(build_task), [video_id](std::shared_ptr<const frame_index> index)
+		{
+			auto& project = *ctx_.current_project;
+			project.end_video_job(video_id, video_job_type::frame_index);
+			if (index == nullptr or !project.videos.contains(video_id))
+			{
+				return;
+			}
+
+			project.videos.get(video_id).set_frame_index(index);
+			if (auto video_it = ctx_.displayed_videos.find(video_id); video_it != ctx_.displayed_videos.end())
+			{
+				video_it->video.set_frame_index(index);
+			}
+		}, job.token);
 	}
 
-	bool project::import_video(std::unique_ptr<video_resource>&& vid_resource, std::optional<video_group_id_t> group_id, bool check_hash, bool set_project_dirty)
+	void project::schedule_generate_proxy(video_id_t video_id)
+	{
+		if (!videos.contains(video_id) or has_video_job(video_id, video_job_type::proxy))
+		{
+			return;
+		}
+
+		auto& vid_resource = videos.get(video_id);
+		if (vid_resource.has_proxy())
+		{
+			return;
+		}
+
+		auto& job = add_video_job(video_id, video_job_type::proxy);
+		auto proxy_task = vid_resource.generate_proxy_task(job.token);
+		if (proxy_task == nullptr)
+		{
+			cancel_video_job(video_id, video_job_type::proxy);
+			return;
+		}
+
+		ctx_.jobs.submit(utils::job_priority::background, std::move(proxy_task), [video_id](bool generated)
+		{
+			auto& project = *ctx_.current_project;
+			project.end_video_job(video_id, video_job_type::proxy);
+			if (!generated or !project.videos.contains(video_id))
+			{
+				return;
+			}
+
+			debug::log("Generated proxy for video {}", video_id);
+			if (auto video_it = ctx_.displayed_videos.find(video_id); video_it != ctx_.displayed_videos.end())
+			{
+				video_it->video.set_proxy_file(project.videos.get(video_id).proxy_path());
+			}
+		}, job.token);
+	}
+
+	void project::cancel_generate_proxy(video_id_t video_id)
+	{
+		cancel_video_job(video_id, video_job_type::proxy);
+	}
+
+	//Stores the hash of a video hashed by schedule_hash_video and schedules the jobs that are cached by it
+	static void on_hash_done(video_id_t video_id, std::vector<uint8_t> sha256)
+	{
+		auto& project = *ctx_.current_project;
+		project.end_video_job(video_id, video_job_type::hash);
+
+		// Hashing is the slowest part of an import, the cache is saved when the last hash is done so a crash doesn't lose it
+		bool hashing = std::any_of(project.video_jobs.begin(), project.video_jobs.end(), [](const auto& pair) { return pair.second.type == video_job_type::hash; });
+		if (!hashing)
+		{
+			ctx_.jobs.submit(utils::job_priority::background, []()
+			{
+				return ctx_.probe_cache.save(ctx_.probe_cache_filepath);
+			}, [](bool saved)
+			{
+				if (!saved)
+				{
+					debug::warn("Failed to save the file cache to {}", ctx_.probe_cache_filepath.u8string());
+				}
+			});
+		}
+
+		auto& videos = project.videos;
+		if (!videos.contains(video_id))
+		{
+			return;
+		}
+
+		if (sha256.size() != utils::hash::sha256_byte_count)
+		{
+			debug::error("Failed to hash video {}", video_id);
+			return;
+		}
+
+		video_resource_metadata metadata;
+		metadata.sha256 = std::array<uint8_t, utils::hash::sha256_byte_count>{};
+		std::copy_n(sha256.begin(), utils::hash::sha256_byte_count, metadata.sha256->begin());
+
+		auto& vid_resource = videos.get(video_id);
+		const auto& old_sha256 = vid_resource.metadata().sha256;
+		if (old_sha256 != metadata.sha256)
+		{
+			if (old_sha256.has_value())
+			{
+				// The frame index belongs to the old file, the new one is cached under the new hash
+				debug::warn("Video {} changed since the project was saved", vid_resource.file_path());
+				vid_resource.set_frame_index(nullptr);
+			}
+
+			for (auto& [id, video] : videos)
+			{
+				if (id != video_id and video->metadata().sha256 == metadata.sha256)
+				{
+					debug::warn("Video {} has the same hash as video {}", video_id, id);
+					break;
+				}
+			}
+			ctx_.is_project_dirty = true;
+		}
+
+		vid_resource.set_metadata(metadata);
+
+		if (project.check_possible_duplicates(video_id))
+		{
+			return;
+		}
+
+		// The thumbnail made during the import couldn't be cached without the hash
+		if (ctx_.app_settings.load_thumbnails and !std::filesystem::exists(vid_resource.thumbnail_cache_path()))
+		{
+			project.schedule_generate_thumbnail(video_id);
+		}
+
+		project.schedule_build_frame_index(video_id);
+		if (ctx_.app_settings.generate_proxies)
+		{
+			project.schedule_generate_proxy(video_id);
+		}
+	}
+
+	void project::schedule_hash_video(video_id_t video_id)
+	{
+		if (!videos.contains(video_id) or has_video_job(video_id, video_job_type::hash))
+		{
+			return;
+		}
+
+		auto& vid_resource = videos.get(video_id);
+		if (vid_resource.hash_verified() or vid_resource.file_path().empty())
+		{
+			return;
+		}
+
+		auto& job = add_video_job(video_id, video_job_type::hash);
+		ctx_.jobs.submit(utils::job_priority::background, [path = std::filesystem::path(vid_resource.file_path()), token = job.token]()
+		{
+			// Stops between reads when the video is removed or the app closes, so a multi-GB hash doesn't hold up the exit
+			return ctx_.probe_cache.sha256(path, token);
+		}, [video_id](std::vector<uint8_t> sha256)
+		{
+			on_hash_done(video_id, std::move(sha256));
+		}, job.token);
+	}
+
+	video_job& project::add_video_job(video_id_t video_id, video_job_type type)
+	{
+		video_job job;
+		job.type = type;
+		job.token = job_token.child();
+		return video_jobs.emplace(video_id, std::move(job))->second;
+	}
+
+	void project::end_video_job(video_id_t video_id, video_job_type type)
+	{
+		auto [begin, end] = video_jobs.equal_range(video_id);
+		auto it = std::find_if(begin, end, [type](const auto& pair) { return pair.second.type == type; });
+		if (it != end)
+		{
+			video_jobs.erase(it);
+		}
+	}
+
+	bool project::has_video_job(video_id_t video_id, video_job_type type) const
+	{
+		auto [begin, end] = video_jobs.equal_range(video_id);
+		return std::any_of(begin, end, [type](const auto& pair) { return pair.second.type == type; });
+	}
+
+	std::optional<float> project::video_job_progress(video_id_t video_id, video_job_type type) const
+	{
+		auto [begin, end] = video_jobs.equal_range(video_id);
+		auto it = std::find_if(begin, end, [type](const auto& pair) { return pair.second.type == type; });
+		if (it == end)
+		{
+			return std::nullopt;
+		}
+
+		return it->second.token.progress();
+	}
+
+	void project::cancel_video_job(video_id_t video_id, video_job_type type)
+	{
+		auto [begin, end] = video_jobs.equal_range(video_id);
+		auto it = std::find_if(begin, end, [type](const auto& pair) { return pair.second.type == type; });
+		if (it == end)
+		{
+			return;
+		}
+
+		it->second.token.cancel();
+		video_jobs.erase(it);
+	}
+
+	//Keeps the resource alive until the jobs that use it are done, they are waited for on a job and the resource is destroyed on the main thread
+	static void release_after_jobs(std::unique_ptr<video_resource>&& vid_resource, std::vector<std::shared_ptr<std::mutex>> resource_mutexes)
+	{
+		auto holder = std::make_shared<std::unique_ptr<video_resource>>(std::move(vid_resource));
+		ctx_.jobs.submit(utils::job_priority::background, [resource_mutexes = std::move(resource_mutexes)]()
+		{
+			for (auto& mutex : resource_mutexes)
+			{
+				std::unique_lock lock(*mutex);
+			}
+		}, [holder]()
+		{
+			holder->reset();
+		});
+	}
+
+	std::vector<std::shared_ptr<std::mutex>> project::cancel_video_jobs(video_id_t video_id)
+	{
+		std::vector<std::shared_ptr<std::mutex>> result;
+		auto [begin, end] = video_jobs.equal_range(video_id);
+		for (auto it = begin; it != end; ++it)
+		{
+			it->second.token.cancel();
+			if (it->second.resource_mutex != nullptr)
+			{
+				result.push_back(it->second.resource_mutex);
+			}
+		}
+		video_jobs.erase(begin, end);
+		return result;
+	}
+
+	void project::cancel_jobs()
+	{
+		job_token.cancel();
+
+		std::unordered_map<video_id_t, std::vector<std::shared_ptr<std::mutex>>> resource_mutexes;
+		for (auto& [video_id, job] : video_jobs)
+		{
+			if (job.resource_mutex != nullptr)
+			{
+				resource_mutexes[video_id].push_back(job.resource_mutex);
+			}
+		}
+		video_jobs.clear();
+
+		// The project is closed after this, so the videos that running jobs still use are taken out of it
+		for (auto& [video_id, mutexes] : resource_mutexes)
+		{
+			release_after_jobs(videos.extract(video_id), std::move(mutexes));
+		}
+	}
+
+	bool project::check_possible_duplicates(video_id_t video_id)
+	{
+		bool removed = false;
+		for (auto it = possible_duplicates.begin(); it != possible_duplicates.end();)
+		{
+			auto [imported_id, existing_id] = *it;
+			if (imported_id != video_id and existing_id != video_id)
+			{
+				++it;
+				continue;
+			}
+
+			if (!videos.contains(imported_id) or !videos.contains(existing_id))
+			{
+				it = possible_duplicates.erase(it);
+				continue;
+			}
+
+			auto& imported_video = videos.get(imported_id);
+			auto& existing_video = videos.get(existing_id);
+			if (!imported_video.hash_verified() or !existing_video.hash_verified())
+			{
+				// Still waiting for the other hash
+				++it;
+				continue;
+			}
+
+			if (imported_video.metadata().sha256 == existing_video.metadata().sha256)
+			{
+				debug::warn("Video {} is already imported as video {}, removing it", imported_video.file_path(), existing_id);
+				schedule_remove_video(imported_id);
+				removed = removed or imported_id == video_id;
+			}
+			it = possible_duplicates.erase(it);
+		}
+
+		return removed;
+	}
+
+	std::vector<std::pair<video_id_t, std::filesystem::path>> project::video_files() const
+	{
+		std::vector<std::pair<video_id_t, std::filesystem::path>> result;
+		result.reserve(videos.size());
+		for (auto& [id, video] : videos)
+		{
+			if (!video->file_path().empty())
+			{
+				result.emplace_back(id, std::filesystem::path(video->file_path()));
+			}
+		}
+		return result;
+	}
+
+	std::vector<video_id_t> project::find_matching_fingerprints(const video_resource& vid_resource, const std::vector<std::pair<video_id_t, std::filesystem::path>>& video_files)
+	{
+		std::vector<video_id_t> result;
+		const auto& fingerprint = vid_resource.fingerprint();
+		if (!fingerprint.has_value())
+		{
+			return result;
+		}
+
+		for (auto& [video_id, path] : video_files)
+		{
+			// The size is a single stat, only the files of the same size are sampled
+			std::error_code error;
+			auto size = std::filesystem::file_size(path, error);
+			if (error or size != fingerprint->size)
+			{
+				continue;
+			}
+
+			if (utils::hash::fingerprint_file(path) == fingerprint)
+			{
+				result.push_back(video_id);
+			}
+		}
+		return result;
+	}
+
+	bool project::import_video(std::unique_ptr<video_resource>&& vid_resource, std::optional<video_group_id_t> group_id, bool check_hash, bool set_project_dirty, std::vector<video_id_t> matching_fingerprints)
 	{
 		if (vid_resource == nullptr)
 		{
@@ -208,14 +789,15 @@ namespace vt
 
 		const auto& metadata = vid_resource->metadata();
 
-		if (check_hash and vid_resource->metadata().sha256.has_value())
+		if (check_hash and metadata.sha256.has_value())
 		{
+			const auto& sha256 = *metadata.sha256;
 			for (auto& [id, video] : videos)
 			{
-				const auto& hash = *video->metadata().sha256;
-				if (hash == vid_resource->metadata().sha256)
+				const auto& video_sha256 = video->metadata().sha256;
+				if (video_sha256.has_value() and *video_sha256 == sha256)
 				{
-					debug::warn("Video with hash: {} is already imported", utils::hash::bytes_to_hex(hash, utils::hash::string_case::lower));
+					debug::warn("Video with hash: {} is already imported", utils::hash::bytes_to_hex(sha256, utils::hash::string_case::lower));
 					return false;
 				}
 			}
@@ -223,12 +805,31 @@ namespace vt
 
 		video_group::video_info group_info{};
 		group_info.id = vid_resource->id();
+		bool needs_hash = !vid_resource->hash_verified();
 		
 		if (!videos.insert(std::move(vid_resource)))
 		{
 			return false;
 		}
 
+		// Equal fingerprints don't prove the files are equal, the duplicate is removed by check_possible_duplicates once both hashes are known
+		for (auto existing_id : matching_fingerprints)
+		{
+			if (!check_hash or !videos.contains(existing_id))
+			{
+				continue;
+			}
+
+			debug::log("Video {} may already be imported as video {}, it will be checked when it's hashed", group_info.id, existing_id);
+			possible_duplicates.emplace(group_info.id, existing_id);
+			schedule_hash_video(existing_id);
+		}
+
+		if (needs_hash)
+		{
+			schedule_hash_video(group_info.id);
+		}
+
 		if (group_id.has_value())
 		{
 			auto group_it = video_groups.find(*group_id);
@@ -476,28 +1077,22 @@ namespace vt
 		}
 
 		ctx_.displayed_videos.erase(id);
+		ctx_.stream_cache.erase(id);
 
-		{
-			auto it = std::find_if(generate_thumbnail_tasks.begin(), generate_thumbnail_tasks.end(), [id](const auto& task) { return task.video_id == id; });
-			if (it != generate_thumbnail_tasks.end())
-			{
-				generate_thumbnail_tasks.erase(it);
-			}
-		}
-		
-		{
-			auto it = std::find_if(video_download_tasks.begin(), video_download_tasks.end(), [id](const auto& task) { return task.video_id == id; });
-			if (it != video_download_tasks.end())
-			{
-				it->task.cancel();
-				it->task.result.get();
-				video_download_tasks.erase(it);
-			}
-		}
+		auto resource_mutexes = cancel_video_jobs(id);
+		thumbnails.erase(id);
+		failed_thumbnails.erase(id);
+		possible_duplicates.erase(id);
 
-		if (videos.erase(id))
+		auto vid_resource = videos.extract(id);
+		if (vid_resource != nullptr)
 		{
 			ctx_.is_project_dirty = true;
+			if (!resource_mutexes.empty())
+			{
+				// A download still uses the resource, it's destroyed once the download stops
+				release_after_jobs(std::move(vid_resource), std::move(resource_mutexes));
+			}
 		}
 	}
 
@@ -685,13 +1280,19 @@ namespace vt
 						video_id_t video_id = vid_resource->id();
 						if (result.import_video(std::move(vid_resource), std::nullopt, false, false))
 						{
-							if (ctx_.app_settings.load_thumbnails)
+							result.schedule_build_frame_index(video_id);
+							if (ctx_.app_settings.generate_proxies)
 							{
-								result.schedule_generate_thumbnail(video_id);
+								result.schedule_generate_proxy(video_id);
 							}
 						}
 					}
 				}
+
+				if (ctx_.app_settings.load_thumbnails)
+				{
+					result.schedule_check_thumbnails();
+				}
 			}
 
 			if (json.contains("groups") and json.at("groups").is_array())
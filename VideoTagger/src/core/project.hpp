@@ -2,6 +2,7 @@
 #include <string>
 #include <filesystem>
 #include <unordered_map>
+#include <unordered_set>
 #include <optional>
 #include <mutex>
 #include <future>
@@ -11,10 +12,12 @@
 #include <tags/tag_storage.hpp>
 #include <tags/tag_timeline.hpp>
 #include <video/video_pool.hpp>
+#include <video/thumbnail_atlas.hpp>
 #include <video/downloadable_video_resource.hpp>
 #include <video/video_group_playlist.hpp>
 #include <video/video_importer.hpp>
 #include <core/input.hpp>
+#include <utils/job_scheduler.hpp>
 
 namespace vt
 {
@@ -45,36 +48,24 @@ namespace vt
 		bool operator()();
 	};
 
-	struct video_import_task
+	enum class video_job_type : uint8_t
 	{
-		std::optional<video_group_id_t> group_id;
-		std::future<std::unique_ptr<video_resource>> task;
+		thumbnail,
+		download,
+		refresh,
+		frame_index,
+		proxy,
+		hash
 	};
 
-	struct generate_thumbnail_task
+	//Job of a video that runs on ctx_.jobs, its result is applied by a completion callback on the main thread
+	struct video_job
 	{
-		video_id_t video_id{};
-		std::function<bool()> task;
-
-		bool operator()();
-	};
-
-	struct video_download_task
-	{
-		video_id_t video_id{};
-		video_download_result task;
-	};
-
-	struct video_refresh_task
-	{
-		video_id_t video_id{};
-		std::future<void> task;
-	};
-
-	struct remove_video_task
-	{
-		video_id_t video_id{};
-		std::future<void> task;
+		video_job_type type{};
+		utils::cancellation_token token;
+		//Set for jobs that use the video resource, they hold it while running and check the token after locking it,
+		//so locking it after cancelling the token waits until the resource isn't used anymore
+		std::shared_ptr<std::mutex> resource_mutex;
 	};
 
 	struct project : public project_info
@@ -87,15 +78,18 @@ namespace vt
 		tag_storage tags;
 		keybind_storage keybinds;
 		std::vector<std::string> displayed_tags;
+		//Thumbnails of the visible tiles, the evicted ones are read from the cache again by request_thumbnail
+		thumbnail_atlas thumbnails;
+		//Videos whose thumbnail couldn't be generated, they aren't requested again until it's scheduled explicitly
+		std::unordered_set<video_id_t> failed_thumbnails;
 
-		//TODO: maybe use async
-		//TODO: add generic task class
+		//Polled by the main window every frame until the importer has the data of the videos
 		std::vector<prepare_video_import_task> prepare_video_import_tasks;
-		std::vector<video_import_task> video_import_tasks;
-		std::vector<generate_thumbnail_task> generate_thumbnail_tasks;
-		std::vector<video_download_task> video_download_tasks;
-		std::vector<video_refresh_task> video_refresh_tasks;
-		std::vector<remove_video_task> remove_video_tasks;
+		//Parent of the tokens of every job of the project, cancelled when the project is closed
+		utils::cancellation_token job_token;
+		std::unordered_multimap<video_id_t, video_job> video_jobs;
+		//Imported videos whose fingerprint matched an existing video, mapped to that video, they're compared by hash when both are hashed
+		std::unordered_multimap<video_id_t, video_id_t> possible_duplicates;
 
 		project() = default;
 		project(const project&) = delete;
@@ -112,12 +106,44 @@ namespace vt
 		void schedule_video_import(typename video_importer::import_data import_data, std::optional<video_group_id_t> group_id);
 		void schedule_video_import(const std::string& importer_id, std::any import_data, std::optional<video_group_id_t> group_id);
 		void schedule_video_download(video_id_t video_id);
-		void schedule_generate_thumbnail(video_id_t video_id);
+		void schedule_generate_thumbnail(video_id_t video_id, utils::job_priority priority = utils::job_priority::background);
+		//Reads the cached thumbnails in one batch and uploads as many as fit in the atlas, the ones that aren't cached are generated
+		void schedule_check_thumbnails();
+		//Reads the thumbnail from the cache or generates it if it's not resident in the atlas, called when its tile becomes visible
+		void request_thumbnail(video_id_t video_id);
 		void schedule_video_refresh(video_id_t video_id);
 		void schedule_remove_video(video_id_t video_id);
+		void schedule_build_frame_index(video_id_t video_id);
+		void schedule_generate_proxy(video_id_t video_id);
+		void cancel_generate_proxy(video_id_t video_id);
+		void schedule_hash_video(video_id_t video_id);
+
+		//Records the job so it's cancelled together with the video, the returned job's token has to be passed to ctx_.jobs
+		video_job& add_video_job(video_id_t video_id, video_job_type type);
+		//Called by the completion callback of the job
+		void end_video_job(video_id_t video_id, video_job_type type);
+		[[nodiscard]] bool has_video_job(video_id_t video_id, video_job_type type) const;
+		//Progress reported by the job, nullopt if the video has no such job or it doesn't report its progress
+		[[nodiscard]] std::optional<float> video_job_progress(video_id_t video_id, video_job_type type) const;
+		void cancel_video_job(video_id_t video_id, video_job_type type);
+		//Cancels the jobs of the video, returns the resource mutexes of the ones that may still use its resource
+		std::vector<std::shared_ptr<std::mutex>> cancel_video_jobs(video_id_t video_id);
+		//Cancels every job of the project, their completion callbacks won't be called
+		//Doesn't wait for the jobs, the videos they still use are moved out of the project and destroyed once the jobs are done
+		void cancel_jobs();
+
+		//Called when a video is hashed, removes the imported duplicates whose hash matched, returns true if video_id is one of them
+		bool check_possible_duplicates(video_id_t video_id);
+
+		//Files of the videos, copied for the import jobs that compare them with the imported file
+		[[nodiscard]] std::vector<std::pair<video_id_t, std::filesystem::path>> video_files() const;
+		//Returns the videos whose file has the same fingerprint as the imported video, reads the files so it must run on a job
+		[[nodiscard]] static std::vector<video_id_t> find_matching_fingerprints(const video_resource& vid_resource, const std::vector<std::pair<video_id_t, std::filesystem::path>>& video_files);
 
 		//TODO: maybe return the imported video or the video with the same hash if it exist and bool inserted
-		bool import_video(std::unique_ptr<video_resource>&& vid_resource, std::optional<video_group_id_t> group_id, bool check_hash = true, bool set_project_dirty = true);
+		//Duplicates are rejected by the hash, matching_fingerprints (from find_matching_fingerprints) only mark possible duplicates that are confirmed by the hash later
+		//Doesn't read any files
+		bool import_video(std::unique_ptr<video_resource>&& vid_resource, std::optional<video_group_id_t> group_id, bool check_hash = true, bool set_project_dirty = true, std::vector<video_id_t> matching_fingerprints = {});
 
 		bool export_segments(const std::filesystem::path& filepath, std::vector<video_group_id_t> group_ids) const;
 
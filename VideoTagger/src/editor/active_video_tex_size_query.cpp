@@ -11,6 +11,7 @@ namespace vt
 
 		auto it = ctx_.displayed_videos.find(focused_id.value());
 		if (it == ctx_.displayed_videos.end()) return std::nullopt;
-		return utils::vec2<uint32_t>{ (uint32_t)it->display_texture.width(), (uint32_t)it->display_texture.height() };
+		// The display texture is scaled to the widget, shapes use the size of the video
+		return utils::vec2<uint32_t>{ (uint32_t)it->video.width(), (uint32_t)it->video.height() };
 	}
 }
@@ -34,7 +34,9 @@ void vt::bindings::bind_project(pybind11::module_& module)
 		auto vid_resource = ctx_.get_video_importer<local_video_importer>().import_video(vid_resource_id, std::filesystem::path(path));
 		if (vid_resource == nullptr) return std::nullopt;
 
-		if (!p.ref.import_video(std::move(vid_resource), std::nullopt)) return std::nullopt;
+		// Scripts run on their own thread, so the files can be compared here
+		auto matching_fingerprints = project::find_matching_fingerprints(*vid_resource, p.ref.video_files());
+		if (!p.ref.import_video(std::move(vid_resource), std::nullopt, true, true, std::move(matching_fingerprints))) return std::nullopt;
 
 		auto& vid = p.ref.videos.get<local_video_resource>(vid_resource_id);
 
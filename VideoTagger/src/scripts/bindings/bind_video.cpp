@@ -1,6 +1,7 @@
 #include "pch.hpp"
 #include "bind_video.hpp"
 #include <core/app_context.hpp>
+#include <utils/hash.hpp>
 #include "proxies.hpp"
 
 void vt::bindings::bind_video(pybind11::module_& module)
@@ -19,5 +20,13 @@ void vt::bindings::bind_video(pybind11::module_& module)
 	.def_property_readonly("size", [](const vt_video& vid) -> std::pair<int, int>
 	{
 		return std::make_pair(vid.width, vid.height);
+	})
+	.def_property_readonly("sha256", [](const vt_video& vid) -> std::optional<std::string>
+	{
+		// Read from the project, because the hash is computed in the background after the import
+		if (!ctx_.current_project.has_value() or !ctx_.current_project->videos.contains(vid.id)) return std::nullopt;
+		const auto& vid_resource = ctx_.current_project->videos.get(vid.id);
+		if (!vid_resource.hash_verified()) return std::nullopt;
+		return utils::hash::bytes_to_hex(*vid_resource.metadata().sha256, utils::hash::string_case::lower);
 	});
 }
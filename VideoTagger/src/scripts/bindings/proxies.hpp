@@ -25,6 +25,25 @@ namespace vt::bindings
 		video_group& ref;
 	};
 
+	//Allocation counters of the packet and frame pools of a displayed video, and the slots allocated by its queues
+	struct vt_pool_stats
+	{
+		video_id_t video_id{};
+		object_pool_stats packets;
+		object_pool_stats frames;
+		size_t packet_queue_slots{};
+		size_t frame_queue_slots{};
+	};
+
+	//Decoding counters and thread counts of a displayed video
+	struct vt_pipeline_stats
+	{
+		video_id_t video_id{};
+		frame_pipeline_stats stats;
+		int decode_threads{};
+		int scale_threads{};
+	};
+
 	struct vt_tag_segment
 	{
 		tag_segment& ref;
@@ -108,8 +108,52 @@ namespace vt
 		.def_property_readonly("is_playing", [](const widgets::video_player& player) -> bool
 		{
 			return player.is_playing();
+		})
+		.def("set_scale_threads", [](widgets::video_player&, std::optional<int> count)
+		{
+			// The decoders and converters belong to the main thread, pipeline_stats shows when the change was applied
+			ctx_.jobs.post([count]()
+			{
+				ctx_.displayed_videos.set_scale_thread_override(count);
+			});
+		})
+		.def_property_readonly("pool_stats", [](const widgets::video_player&) -> std::vector<bindings::vt_pool_stats>
+		{
+			std::vector<bindings::vt_pool_stats> result;
+			for (const auto& video_data : ctx_.displayed_videos)
+			{
+				auto pipeline_stats = video_data.video.pipeline_stats();
+				result.push_back({ video_data.id, video_data.video.packet_pool_stats(), video_data.video.frame_pool_stats(), pipeline_stats.packet_queue_slots, pipeline_stats.frame_queue_slots });
+			}
+			return result;
+		})
+		.def_property_readonly("pipeline_stats", [](const widgets::video_player&) -> std::vector<bindings::vt_pipeline_stats>
+		{
+			std::vector<bindings::vt_pipeline_stats> result;
+			for (const auto& video_data : ctx_.displayed_videos)
+			{
+				result.push_back({ video_data.id, video_data.video.pipeline_stats(), video_data.video.decode_thread_count(), video_data.video.scale_thread_count() });
+			}
+			return result;
 		});
 
+		py::class_<bindings::vt_pipeline_stats>(this_module, "PipelineStats")
+		.def_property_readonly("video_id", [](const bindings::vt_pipeline_stats& stats) { return stats.video_id; })
+		.def_property_readonly("decoded_frames", [](const bindings::vt_pipeline_stats& stats) { return stats.stats.decoded_frames; })
+		.def_property_readonly("dropped_frames", [](const bindings::vt_pipeline_stats& stats) { return stats.stats.dropped_frames; })
+		.def_property_readonly("consumer_stalls", [](const bindings::vt_pipeline_stats& stats) { return stats.stats.consumer_stalls; })
+		.def_property_readonly("decode_threads", [](const bindings::vt_pipeline_stats& stats) { return stats.decode_threads; })
+		.def_property_readonly("scale_threads", [](const bindings::vt_pipeline_stats& stats) { return stats.scale_threads; });
+
+		py::class_<bindings::vt_pool_stats>(this_module, "PoolStats")
+		.def_property_readonly("video_id", [](const bindings::vt_pool_stats& stats) { return stats.video_id; })
+		.def_property_readonly("packet_allocations", [](const bindings::vt_pool_stats& stats) { return stats.packets.allocations; })
+		.def_property_readonly("packet_reuses", [](const bindings::vt_pool_stats& stats) { return stats.packets.reuses; })
+		.def_property_readonly("frame_allocations", [](const bindings::vt_pool_stats& stats) { return stats.frames.allocations; })
+		.def_property_readonly("frame_reuses", [](const bindings::vt_pool_stats& stats) { return stats.frames.reuses; })
+		.def_property_readonly("packet_queue_slots", [](const bindings::vt_pool_stats& stats) { return stats.packet_queue_slots; })
+		.def_property_readonly("frame_queue_slots", [](const bindings::vt_pool_stats& stats) { return stats.frame_queue_slots; });
+
 		this_module.attr("player") = &ctx_.player;
 
 		bindings::bind_tags(this_module);
@@ -5,36 +5,116 @@
 
 namespace vt::utils::hash
 {
-	uint64_t fnv_hash(const std::filesystem::path& filepath)
+	static constexpr uint64_t fnv_offset_basis = 14695981039346656037ull;
+	static constexpr uint64_t fnv_prime = 1099511628211ull;
+
+	static uint64_t fnv_update(uint64_t hash, const uint8_t* data, size_t size)
 	{
-		static constexpr size_t file_buffer_size = 4096;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= data[i];
+			hash *= fnv_prime;
+		}
+		return hash;
+	}
 
-		std::ifstream in(filepath, std::ios::binary);
+	//Reads the whole file in large blocks, the stream is unbuffered so the data goes straight into the buffer
+	//Stops and returns false when the token is cancelled, the progress is reported through it
+	template<typename function_t>
+	static bool read_file_blocks(const std::filesystem::path& filepath, const cancellation_token& token, function_t&& on_block)
+	{
+		std::error_code error;
+		uint64_t file_size = std::filesystem::file_size(filepath, error);
+		uint64_t total_read_bytes = 0;
+
+		std::ifstream in;
+		in.rdbuf()->pubsetbuf(nullptr, 0);
+		in.open(filepath, std::ios::binary);
 		if (!in.is_open())
 		{
-			return 0;
+			return false;
 		}
 
-		uint64_t hash = 14695981039346656037ull;
-
-		std::array<uint8_t, file_buffer_size> file_buffer{};
-		
-		while (!in.eof())
+		std::vector<uint8_t> file_buffer(file_read_size);
+		while (in)
 		{
-			in.read((char*)file_buffer.data(), file_buffer_size);
-			auto read_bytes = in.gcount();
+			if (token.is_cancelled())
+			{
+				return false;
+			}
+
+			in.read(reinterpret_cast<char*>(file_buffer.data()), file_buffer.size());
+			auto read_bytes = static_cast<size_t>(in.gcount());
 			if (read_bytes == 0)
 			{
 				break;
 			}
 
-			for (std::streamsize i = 0; i < read_bytes; i++)
+			if (!on_block(file_buffer.data(), read_bytes))
+			{
+				return false;
+			}
+
+			total_read_bytes += read_bytes;
+			if (!error and file_size > 0)
 			{
-				hash ^= file_buffer[i];
-				hash *= 1099511628211ull;
+				token.set_progress(static_cast<float>(static_cast<double>(total_read_bytes) / file_size));
 			}
 		}
-		return hash;
+		return !in.bad();
+	}
+
+	uint64_t fnv_hash(const std::filesystem::path& filepath)
+	{
+		uint64_t hash = fnv_offset_basis;
+		bool success = read_file_blocks(filepath, cancellation_token{}, [&hash](const uint8_t* data, size_t size)
+		{
+			hash = fnv_update(hash, data, size);
+			return true;
+		});
+
+		return success ? hash : 0;
+	}
+
+	std::optional<file_fingerprint> fingerprint_file(const std::filesystem::path& filepath)
+	{
+		std::error_code error;
+		auto file_size = std::filesystem::file_size(filepath, error);
+		if (error)
+		{
+			return std::nullopt;
+		}
+
+		std::ifstream in(filepath, std::ios::binary);
+		if (!in.is_open())
+		{
+			return std::nullopt;
+		}
+
+		file_fingerprint result;
+		result.size = static_cast<uint64_t>(file_size);
+		result.sample_hash = fnv_update(fnv_offset_basis, reinterpret_cast<const uint8_t*>(&result.size), sizeof(result.size));
+
+		// Small files are hashed whole, otherwise the blocks are spread evenly from the start to the end of the file
+		uint64_t sampled_size = fingerprint_block_size * fingerprint_block_count;
+		uint64_t block_count = result.size <= sampled_size ? 1 : fingerprint_block_count;
+		uint64_t block_size = result.size <= sampled_size ? result.size : fingerprint_block_size;
+		uint64_t block_stride = block_count > 1 ? (result.size - block_size) / (block_count - 1) : 0;
+
+		std::vector<uint8_t> block(static_cast<size_t>(block_size));
+		for (uint64_t i = 0; i < block_count; i++)
+		{
+			in.seekg(static_cast<std::streamoff>(i * block_stride));
+			in.read(reinterpret_cast<char*>(block.data()), block.size());
+			if (static_cast<uint64_t>(in.gcount()) != block_size)
+			{
+				return std::nullopt;
+			}
+
+			result.sample_hash = fnv_update(result.sample_hash, block.data(), block.size());
+		}
+
+		return result;
 	}
 
 	std::vector<uint8_t> sha256(std::string_view string)
@@ -44,57 +124,95 @@ namespace vt::utils::hash
 		return result;
 	}
 
-	std::vector<uint8_t> sha256_file(const std::filesystem::path& filepath)
+	std::vector<uint8_t> sha256_file(const std::filesystem::path& filepath, const cancellation_token& token)
 	{
-		static constexpr size_t file_buffer_size = 4096;
+		sha256_stream hash;
+		bool success = read_file_blocks(filepath, token, [&hash](const uint8_t* data, size_t size)
+		{
+			return hash.update(data, size);
+		});
 
-		std::ifstream in(filepath, std::ios::binary);
-		if (!in.is_open())
+		if (!success)
 		{
 			return {};
 		}
 
-		EVP_MD_CTX* context = EVP_MD_CTX_new();
-		if (context == nullptr)
+		return hash.finish();
+	}
+
+	sha256_stream::sha256_stream() : context_{ EVP_MD_CTX_new() }
+	{
+		if (context_ != nullptr and EVP_DigestInit_ex(context_, EVP_sha256(), nullptr) != 1)
 		{
-			return {};
+			EVP_MD_CTX_free(context_);
+			context_ = nullptr;
 		}
+	}
 
-		if (EVP_DigestInit_ex(context, EVP_sha256(), nullptr) != 1)
+	sha256_stream::sha256_stream(sha256_stream&& other) noexcept : context_{ other.context_ }
+	{
+		other.context_ = nullptr;
+	}
+
+	sha256_stream::~sha256_stream()
+	{
+		EVP_MD_CTX_free(context_);
+	}
+
+	sha256_stream& sha256_stream::operator=(sha256_stream&& other) noexcept
+	{
+		if (this != &other)
 		{
-			EVP_MD_CTX_free(context);
-			return {};
+			EVP_MD_CTX_free(context_);
+			context_ = other.context_;
+			other.context_ = nullptr;
 		}
 
-		std::array<uint8_t, file_buffer_size> file_buffer{};
-		while (!in.eof())
+		return *this;
+	}
+
+	bool sha256_stream::update(const void* data, size_t size)
+	{
+		if (context_ == nullptr)
 		{
-			in.read((char*)file_buffer.data(), file_buffer_size);
-			auto read_bytes = in.gcount();
-			if (read_bytes == 0)
-			{
-				break;
-			}
+			return false;
+		}
 
-			if (EVP_DigestUpdate(context, file_buffer.data(), read_bytes) != 1)
-			{
-				EVP_MD_CTX_free(context);
-				return {};
-			}
+		if (EVP_DigestUpdate(context_, data, size) != 1)
+		{
+			EVP_MD_CTX_free(context_);
+			context_ = nullptr;
+			return false;
 		}
 
-		std::vector<uint8_t> result(SHA256_DIGEST_LENGTH, 0);
-		if (EVP_DigestFinal_ex(context, result.data(), nullptr) != 1)
+		return true;
+	}
+
+	std::vector<uint8_t> sha256_stream::finish()
+	{
+		if (context_ == nullptr)
 		{
-			EVP_MD_CTX_free(context);
 			return {};
 		}
 
-		EVP_MD_CTX_free(context);
+		std::vector<uint8_t> result(SHA256_DIGEST_LENGTH, 0);
+		bool success = EVP_DigestFinal_ex(context_, result.data(), nullptr) == 1;
+		EVP_MD_CTX_free(context_);
+		context_ = nullptr;
+
+		if (!success)
+		{
+			return {};
+		}
 
 		return result;
 	}
 
+	bool sha256_stream::failed() const
+	{
+		return context_ == nullptr;
+	}
+
 	std::vector<uint8_t> hex_to_bytes(std::string_view hex_string)
 	{
 		std::vector<uint8_t> result(hex_string.size() / 2);
@@ -1,17 +1,71 @@
 #pragma once
 #include <filesystem>
 #include <cstdint>
+#include <optional>
 #include <string_view>
 #include <vector>
+#include <utils/job_scheduler.hpp>
+
+// Same as the typedef of EVP_MD_CTX, so the header doesn't need openssl
+struct evp_md_ctx_st;
 
 namespace vt::utils::hash
 {
+	//Size of the reads used to hash whole files
+	static constexpr size_t file_read_size = 1024 * 1024;
+
 	extern uint64_t fnv_hash(const std::filesystem::path& filepath);
 
+	static constexpr size_t fingerprint_block_size = 64 * 1024;
+	static constexpr size_t fingerprint_block_count = 8;
+
+	//Cheap pre-hash made from the file size and a few sampled blocks
+	//Equal files always have equal fingerprints, different fingerprints mean the files are different
+	struct file_fingerprint
+	{
+		uint64_t size{};
+		uint64_t sample_hash{};
+
+		bool operator==(const file_fingerprint& other) const
+		{
+			return size == other.size and sample_hash == other.sample_hash;
+		}
+
+		bool operator!=(const file_fingerprint& other) const
+		{
+			return !(*this == other);
+		}
+	};
+
+	extern std::optional<file_fingerprint> fingerprint_file(const std::filesystem::path& filepath);
+
 	static constexpr auto sha256_byte_count = 32;
 
 	extern std::vector<uint8_t> sha256(std::string_view string);
-	extern std::vector<uint8_t> sha256_file(const std::filesystem::path& filepath);
+	//Returns an empty vector if the file can't be read or the token is cancelled, which is checked after every read
+	extern std::vector<uint8_t> sha256_file(const std::filesystem::path& filepath, const cancellation_token& token = {});
+
+	//Incremental sha256, for data that arrives in parts
+	class sha256_stream
+	{
+	public:
+		sha256_stream();
+		sha256_stream(const sha256_stream&) = delete;
+		sha256_stream(sha256_stream&& other) noexcept;
+		~sha256_stream();
+
+		sha256_stream& operator=(const sha256_stream&) = delete;
+		sha256_stream& operator=(sha256_stream&& other) noexcept;
+
+		//Returns false if hashing failed, all later updates are ignored
+		bool update(const void* data, size_t size);
+		//Returns an empty vector if hashing failed, the stream can't be updated after that
+		[[nodiscard]] std::vector<uint8_t> finish();
+		[[nodiscard]] bool failed() const;
+
+	private:
+		evp_md_ctx_st* context_{};
+	};
 
 	enum class string_case
 	{
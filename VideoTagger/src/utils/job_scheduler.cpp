@@ -0,0 +1,430 @@
+#include "pch.hpp"
+#include "job_scheduler.hpp"
+#include <core/debug.hpp>
+
+namespace vt::utils
+{
+	//Lets jobs that submit other jobs push them to the queue of the worker they run on
+	static thread_local const job_scheduler* current_scheduler{};
+	static thread_local size_t current_worker{};
+
+	cancellation_token::cancellation_token() : state_{ std::make_shared<state>() }
+	{
+	}
+
+	cancellation_token cancellation_token::child() const
+	{
+		cancellation_token result;
+		result.state_->parent = state_;
+		return result;
+	}
+
+	void cancellation_token::cancel()
+	{
+		state_->cancelled = true;
+	}
+
+	bool cancellation_token::is_cancelled() const
+	{
+		for (const state* it = state_.get(); it != nullptr; it = it->parent.get())
+		{
+			if (it->cancelled)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void cancellation_token::set_progress(float progress) const
+	{
+		state_->progress = std::clamp(progress, 0.0f, 1.0f);
+	}
+
+	std::optional<float> cancellation_token::progress() const
+	{
+		float result = state_->progress;
+		if (result < 0.0f)
+		{
+			return std::nullopt;
+		}
+		return result;
+	}
+
+	job_scheduler::job_scheduler(size_t thread_count) : thread_count_{ std::max<size_t>(thread_count, 2) }
+	{
+		update_limits();
+
+		running_tokens_.resize(thread_count_);
+		queues_.reserve(thread_count_);
+		for (size_t i = 0; i < thread_count_; i++)
+		{
+			queues_.push_back(std::make_unique<worker_queue>());
+		}
+	}
+
+	job_scheduler::~job_scheduler()
+	{
+		stop();
+	}
+
+	void job_scheduler::stop()
+	{
+		{
+			std::unique_lock lock(mutex_);
+			stop_requested_ = true;
+		}
+		condition_.notify_all();
+
+		for (auto& thread : threads_)
+		{
+			thread.join();
+		}
+		threads_.clear();
+
+		// The dropped jobs and completions may own resources that have to be released before the things they refer to,
+		// they're destroyed outside of the locks
+		for (auto& queue : queues_)
+		{
+			std::array<std::deque<job>, job_priority_count> jobs;
+			{
+				std::unique_lock lock(queue->mutex);
+				jobs.swap(queue->jobs);
+			}
+
+			for (size_t priority = 0; priority < job_priority_count; priority++)
+			{
+				pending_[priority] -= jobs[priority].size();
+				cancelled_ += jobs[priority].size();
+			}
+		}
+
+		std::deque<completion> completions;
+		{
+			std::unique_lock lock(completions_mutex_);
+			completions.swap(completions_);
+		}
+	}
+
+	void job_scheduler::post(std::function<void()> function, cancellation_token token)
+	{
+		{
+			std::unique_lock lock(mutex_);
+			if (stop_requested_)
+			{
+				return;
+			}
+		}
+
+		std::unique_lock lock(completions_mutex_);
+		completions_.push_back({ std::move(function), std::move(token) });
+	}
+
+	void job_scheduler::parallel_for(size_t count, const std::function<void(size_t)>& function)
+	{
+		struct batch
+		{
+			std::atomic<size_t> next_index{};
+			size_t count{};
+			const std::function<void(size_t)>* function{};
+			std::mutex mutex;
+			std::condition_variable condition;
+			size_t done_count{};
+		};
+
+		if (count == 0)
+		{
+			return;
+		}
+
+		auto state = std::make_shared<batch>();
+		state->count = count;
+		state->function = &function;
+
+		// Helpers that start after every index was taken return without touching the function
+		auto work = [state]()
+		{
+			size_t done{};
+			for (size_t i = state->next_index++; i < state->count; i = state->next_index++)
+			{
+				(*state->function)(i);
+				++done;
+			}
+
+			if (done != 0)
+			{
+				std::unique_lock lock(state->mutex);
+				state->done_count += done;
+				if (state->done_count == state->count)
+				{
+					state->condition.notify_all();
+				}
+			}
+		};
+
+		size_t helper_count = std::min(count, thread_count_) - 1;
+		for (size_t i = 0; i < helper_count; i++)
+		{
+			push_job(job_priority::interactive, work, cancellation_token{});
+		}
+		work();
+
+		std::unique_lock lock(state->mutex);
+		state->condition.wait(lock, [&state]() { return state->done_count == state->count; });
+	}
+
+	void job_scheduler::dispatch_completions(std::chrono::nanoseconds budget)
+	{
+		auto start = std::chrono::steady_clock::now();
+		while (std::chrono::steady_clock::now() - start < budget)
+		{
+			completion next;
+			{
+				std::unique_lock lock(completions_mutex_);
+				if (completions_.empty())
+				{
+					return;
+				}
+
+				next = std::move(completions_.front());
+				completions_.pop_front();
+			}
+
+			if (!next.token.is_cancelled())
+			{
+				next.function();
+			}
+		}
+	}
+
+	void job_scheduler::set_reserved_threads(size_t count)
+	{
+		{
+			std::unique_lock lock(mutex_);
+			if (reserved_threads_ == count)
+			{
+				return;
+			}
+
+			reserved_threads_ = count;
+			update_limits();
+			// Jobs that were skipped because of the old limits might fit now
+			++generation_;
+		}
+		condition_.notify_all();
+	}
+
+	size_t job_scheduler::thread_count() const
+	{
+		return thread_count_;
+	}
+
+	job_scheduler_stats job_scheduler::stats() const
+	{
+		job_scheduler_stats result;
+		result.thread_count = thread_count_;
+		for (size_t i = 0; i < job_priority_count; i++)
+		{
+			result.pending[i] = pending_[i];
+		}
+		{
+			std::unique_lock lock(mutex_);
+			result.running = running_;
+			for (const auto& token : running_tokens_)
+			{
+				auto progress = token.has_value() ? token->progress() : std::nullopt;
+				if (progress.has_value())
+				{
+					result.progress.push_back(*progress);
+				}
+			}
+		}
+		{
+			std::unique_lock lock(completions_mutex_);
+			result.completions = completions_.size();
+		}
+		result.finished = finished_;
+		result.cancelled = cancelled_;
+		result.stolen = stolen_;
+		return result;
+	}
+
+	void job_scheduler::push_job(job_priority priority, std::function<void()>&& function, cancellation_token&& token)
+	{
+		{
+			std::unique_lock lock(mutex_);
+			if (stop_requested_)
+			{
+				return;
+			}
+		}
+
+		// Counted first, so a worker that takes the job right away never sees it below zero
+		++pending_[static_cast<size_t>(priority)];
+
+		size_t queue_index = current_scheduler == this ? current_worker : next_queue_++ % thread_count_;
+		{
+			auto& queue = *queues_[queue_index];
+			std::unique_lock lock(queue.mutex);
+			queue.jobs[static_cast<size_t>(priority)].push_back({ std::move(function), std::move(token), priority });
+		}
+
+		{
+			std::unique_lock lock(mutex_);
+			++generation_;
+
+			if (threads_.empty() and !stop_requested_)
+			{
+				for (size_t i = 0; i < thread_count_; i++)
+				{
+					threads_.emplace_back(&job_scheduler::run, this, i);
+				}
+			}
+		}
+		condition_.notify_one();
+	}
+
+	void job_scheduler::log_job_error(const std::exception& ex)
+	{
+		debug::error("Job failed: {}", ex.what());
+	}
+
+	void job_scheduler::update_limits()
+	{
+		// One import or background job can always run, so they never stop completely
+		size_t available = thread_count_ - std::min(reserved_threads_, thread_count_);
+		shared_limit_ = std::max<size_t>(std::min(available, thread_count_ - 1), 1);
+		background_limit_ = std::max<size_t>(available / 2, 1);
+	}
+
+	bool job_scheduler::try_reserve(job_priority priority)
+	{
+		std::unique_lock lock(mutex_);
+		size_t shared_running = running_[static_cast<size_t>(job_priority::import)] + running_[static_cast<size_t>(job_priority::background)];
+		if (priority == job_priority::background and running_[static_cast<size_t>(priority)] >= background_limit_)
+		{
+			return false;
+		}
+		if (priority != job_priority::interactive and shared_running >= shared_limit_)
+		{
+			return false;
+		}
+
+		++running_[static_cast<size_t>(priority)];
+		return true;
+	}
+
+	void job_scheduler::release(job_priority priority, bool finished)
+	{
+		{
+			std::unique_lock lock(mutex_);
+			--running_[static_cast<size_t>(priority)];
+			if (!finished or priority == job_priority::interactive)
+			{
+				return;
+			}
+
+			// A limited slot is free again, a worker that skipped such a job can take it now
+			++generation_;
+		}
+		condition_.notify_one();
+	}
+
+	std::optional<job_scheduler::job> job_scheduler::take_job(size_t worker_index)
+	{
+		for (size_t priority = 0; priority < job_priority_count; priority++)
+		{
+			if (pending_[priority] == 0 or !try_reserve(static_cast<job_priority>(priority)))
+			{
+				continue;
+			}
+
+			// The own queue is used in order, other queues are stolen from the back
+			for (size_t i = 0; i < thread_count_; i++)
+			{
+				auto& queue = *queues_[(worker_index + i) % thread_count_];
+				std::unique_lock lock(queue.mutex);
+				auto& jobs = queue.jobs[priority];
+				if (jobs.empty())
+				{
+					continue;
+				}
+
+				std::optional<job> result;
+				if (i == 0)
+				{
+					result = std::move(jobs.front());
+					jobs.pop_front();
+				}
+				else
+				{
+					result = std::move(jobs.back());
+					jobs.pop_back();
+					++stolen_;
+				}
+				--pending_[priority];
+				return result;
+			}
+
+			release(static_cast<job_priority>(priority), false);
+		}
+
+		return std::nullopt;
+	}
+
+	void job_scheduler::run(size_t worker_index)
+	{
+		current_scheduler = this;
+		current_worker = worker_index;
+
+		while (true)
+		{
+			uint64_t seen_generation{};
+			{
+				std::unique_lock lock(mutex_);
+				if (stop_requested_)
+				{
+					return;
+				}
+				seen_generation = generation_;
+			}
+
+			auto next = take_job(worker_index);
+			if (!next.has_value())
+			{
+				std::unique_lock lock(mutex_);
+				condition_.wait(lock, [this, seen_generation]() { return stop_requested_ or generation_ != seen_generation; });
+				continue;
+			}
+
+			if (next->token.is_cancelled())
+			{
+				++cancelled_;
+			}
+			else
+			{
+				{
+					std::unique_lock lock(mutex_);
+					running_tokens_[worker_index] = next->token;
+				}
+
+				try
+				{
+					next->function();
+				}
+				catch (const std::exception& ex)
+				{
+					log_job_error(ex);
+				}
+				++finished_;
+
+				{
+					std::unique_lock lock(mutex_);
+					running_tokens_[worker_index].reset();
+				}
+			}
+
+			release(next->priority, true);
+		}
+	}
+}
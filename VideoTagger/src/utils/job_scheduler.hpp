@@ -0,0 +1,224 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace vt::utils
+{
+	enum class job_priority : uint8_t
+	{
+		//Work the user is waiting for, like visible thumbnails and videos that are about to be displayed
+		interactive,
+		//Imports of new videos
+		import,
+		//Everything that can wait, like hashes, proxies and frame indexes
+		background
+	};
+
+	static constexpr size_t job_priority_count = 3;
+
+	//Shared by a job and its owner, jobs check it at the points where they can stop early
+	//Long jobs also report their progress through it
+	class cancellation_token
+	{
+	public:
+		cancellation_token();
+
+		//The child is cancelled together with this token, cancelling the child doesn't affect this token
+		[[nodiscard]] cancellation_token child() const;
+		void cancel();
+		[[nodiscard]] bool is_cancelled() const;
+
+		//Progress from 0 to 1, const because jobs only get a const token, the progress isn't shared with the children
+		void set_progress(float progress) const;
+		//nullopt until the job reports its progress
+		[[nodiscard]] std::optional<float> progress() const;
+
+	private:
+		struct state
+		{
+			std::atomic<bool> cancelled{};
+			std::atomic<float> progress{ -1.0f };
+			std::shared_ptr<const state> parent;
+		};
+
+		std::shared_ptr<state> state_;
+	};
+
+	struct job_scheduler_stats
+	{
+		size_t thread_count{};
+		std::array<size_t, job_priority_count> pending{};
+		std::array<size_t, job_priority_count> running{};
+		size_t completions{};
+		uint64_t finished{};
+		uint64_t cancelled{};
+		uint64_t stolen{};
+		//Progress of the running jobs that report it
+		std::vector<float> progress;
+	};
+
+	//Fixed number of worker threads shared by every kind of job, threads are started on the first submit
+	//Every worker has its own queues, jobs submitted from a worker stay on it and idle workers steal from the others
+	//Higher priorities are always taken first, import and background jobs never occupy every worker,
+	//so interactive jobs don't wait for long running background work
+	class job_scheduler
+	{
+	public:
+		explicit job_scheduler(size_t thread_count);
+		job_scheduler(const job_scheduler&) = delete;
+		job_scheduler(job_scheduler&&) = delete;
+		//Calls stop
+		~job_scheduler();
+
+		job_scheduler& operator=(const job_scheduler&) = delete;
+		job_scheduler& operator=(job_scheduler&&) = delete;
+
+		//The job is dropped if the token is cancelled before it starts, its future will throw std::future_error
+		template<typename function_t>
+		[[nodiscard]] std::future<std::invoke_result_t<function_t>> submit(job_priority priority, function_t&& function, cancellation_token token = {});
+		//on_complete gets the result on the main thread in dispatch_completions, it isn't called if the token is cancelled before that
+		//If the function throws, on_complete still gets a value-initialized result, so the owner can clean up, callbacks treat it as a failure
+		template<typename function_t, typename callback_t>
+		void submit(job_priority priority, function_t&& function, callback_t&& on_complete, cancellation_token token = {});
+		//Runs the function on the main thread in the next dispatch_completions
+		void post(std::function<void()> function, cancellation_token token = {});
+
+		//Calls the function for every index from 0 to count and returns when all calls are done
+		//The calling thread takes part, so it finishes even when every worker is busy
+		void parallel_for(size_t count, const std::function<void(size_t)>& function);
+
+		//Runs the completion callbacks of finished jobs until the budget is used up, must be called on the main thread
+		void dispatch_completions(std::chrono::nanoseconds budget = std::chrono::nanoseconds::max());
+
+		//Threads that are busy outside of the scheduler, like the decoders of the displayed videos,
+		//import and background jobs are limited so together with them they don't use more threads than the workers
+		void set_reserved_threads(size_t count);
+
+		//Joins the workers, jobs that haven't started yet and completions that weren't dispatched are dropped, running jobs are waited for
+		//Jobs submitted after this are dropped, must be called on the main thread before anything the jobs use is destroyed
+		void stop();
+
+		[[nodiscard]] size_t thread_count() const;
+		[[nodiscard]] job_scheduler_stats stats() const;
+
+	private:
+		struct job
+		{
+			std::function<void()> function;
+			cancellation_token token;
+			job_priority priority{};
+		};
+
+		struct worker_queue
+		{
+			std::mutex mutex;
+			std::array<std::deque<job>, job_priority_count> jobs;
+		};
+
+		struct completion
+		{
+			std::function<void()> function;
+			cancellation_token token;
+		};
+
+		size_t thread_count_{};
+		//Import and background jobs together never take the last worker, background jobs alone take at most half of them,
+		//both are lowered by the reserved threads
+		size_t shared_limit_{};
+		size_t background_limit_{};
+		std::vector<std::unique_ptr<worker_queue>> queues_;
+		std::vector<std::thread> threads_;
+		std::atomic<size_t> next_queue_{};
+
+		mutable std::mutex mutex_;
+		std::condition_variable condition_;
+		//Changes whenever a job is pushed or a limited job finishes, idle workers wait for it
+		uint64_t generation_{};
+		std::array<size_t, job_priority_count> running_{};
+		//Tokens of the jobs the workers are running, read by stats for their progress
+		std::vector<std::optional<cancellation_token>> running_tokens_;
+		size_t reserved_threads_{};
+		bool stop_requested_{};
+
+		mutable std::mutex completions_mutex_;
+		std::deque<completion> completions_;
+
+		std::array<std::atomic<size_t>, job_priority_count> pending_{};
+		std::atomic<uint64_t> finished_{};
+		std::atomic<uint64_t> cancelled_{};
+		std::atomic<uint64_t> stolen_{};
+
+		static void log_job_error(const std::exception& ex);
+		//The mutex must be locked, except in the constructor
+		void update_limits();
+		void push_job(job_priority priority, std::function<void()>&& function, cancellation_token&& token);
+		//Reserves a running slot of the priority, the mutex must not be locked
+		bool try_reserve(job_priority priority);
+		void release(job_priority priority, bool finished);
+		std::optional<job> take_job(size_t worker_index);
+		void run(size_t worker_index);
+	};
+
+	template<typename function_t>
+	inline std::future<std::invoke_result_t<function_t>> job_scheduler::submit(job_priority priority, function_t&& function, cancellation_token token)
+	{
+		// std::function requires a copyable callable, so the task is shared
+		auto task = std::make_shared<std::packaged_task<std::invoke_result_t<function_t>()>>(std::forward<function_t>(function));
+		auto result = task->get_future();
+		push_job(priority, [task]() { (*task)(); }, std::move(token));
+		return result;
+	}
+
+	template<typename function_t, typename callback_t>
+	inline void job_scheduler::submit(job_priority priority, function_t&& function, callback_t&& on_complete, cancellation_token token)
+	{
+		using result_t = std::invoke_result_t<function_t>;
+		static_assert(std::is_void_v<result_t> or std::is_default_constructible_v<result_t>, "The result has to be default constructible, it's passed to the callback when the job throws");
+
+		auto functions = std::make_shared<std::pair<std::decay_t<function_t>, std::decay_t<callback_t>>>(std::forward<function_t>(function), std::forward<callback_t>(on_complete));
+		push_job(priority, [this, functions, token]()
+		{
+			// The callback is always posted, otherwise the owner would wait for the job forever
+			if constexpr (std::is_void_v<result_t>)
+			{
+				try
+				{
+					functions->first();
+				}
+				catch (const std::exception& ex)
+				{
+					log_job_error(ex);
+				}
+				post([functions]() { functions->second(); }, token);
+			}
+			else
+			{
+				// Results can be move only, so they are shared instead of copied into the callback
+				std::shared_ptr<result_t> result;
+				try
+				{
+					result = std::make_shared<result_t>(functions->first());
+				}
+				catch (const std::exception& ex)
+				{
+					log_job_error(ex);
+					result = std::make_shared<result_t>();
+				}
+				post([functions, result]() { functions->second(std::move(*result)); }, token);
+			}
+		}, cancellation_token{ token });
+	}
+}
@@ -0,0 +1,327 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace vt
+{
+	//Double ended queue in a contiguous buffer, only allocates when it runs out of capacity
+	//A push onto a full buffer doubles the capacity and moves the elements, the capacity is never given back,
+	//so a queue whose user bounds its size stops allocating once it reached its largest size
+	template<typename value_t>
+	class ring_buffer
+	{
+	public:
+		template<typename ring_buffer_t, typename element_t>
+		class basic_iterator
+		{
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = value_t;
+			using difference_type = std::ptrdiff_t;
+			using pointer = element_t*;
+			using reference = element_t&;
+
+			basic_iterator() = default;
+			basic_iterator(ring_buffer_t* buffer, size_t index) : buffer_{ buffer }, index_{ index } {}
+
+			//Allows conversion from iterator to const_iterator
+			template<typename other_ring_buffer_t, typename other_element_t>
+			basic_iterator(const basic_iterator<other_ring_buffer_t, other_element_t>& other) : buffer_{ other.buffer_ }, index_{ other.index_ } {}
+
+			reference operator*() const
+			{
+				return (*buffer_)[index_];
+			}
+
+			pointer operator->() const
+			{
+				return &(*buffer_)[index_];
+			}
+
+			reference operator[](difference_type offset) const
+			{
+				return (*buffer_)[index_ + offset];
+			}
+
+			basic_iterator& operator++()
+			{
+				++index_;
+				return *this;
+			}
+
+			basic_iterator operator++(int)
+			{
+				auto result = *this;
+				++index_;
+				return result;
+			}
+
+			basic_iterator& operator--()
+			{
+				--index_;
+				return *this;
+			}
+
+			basic_iterator operator--(int)
+			{
+				auto result = *this;
+				--index_;
+				return result;
+			}
+
+			basic_iterator& operator+=(difference_type offset)
+			{
+				index_ += offset;
+				return *this;
+			}
+
+			basic_iterator& operator-=(difference_type offset)
+			{
+				index_ -= offset;
+				return *this;
+			}
+
+			basic_iterator operator+(difference_type offset) const
+			{
+				return basic_iterator(buffer_, index_ + offset);
+			}
+
+			basic_iterator operator-(difference_type offset) const
+			{
+				return basic_iterator(buffer_, index_ - offset);
+			}
+
+			difference_type operator-(const basic_iterator& other) const
+			{
+				return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+			}
+
+			bool operator==(const basic_iterator& other) const
+			{
+				return buffer_ == other.buffer_ and index_ == other.index_;
+			}
+
+			bool operator!=(const basic_iterator& other) const
+			{
+				return !(*this == other);
+			}
+
+			bool operator<(const basic_iterator& other) const
+			{
+				return index_ < other.index_;
+			}
+
+			bool operator>(const basic_iterator& other) const
+			{
+				return other < *this;
+			}
+
+			bool operator<=(const basic_iterator& other) const
+			{
+				return !(other < *this);
+			}
+
+			bool operator>=(const basic_iterator& other) const
+			{
+				return !(*this < other);
+			}
+
+		private:
+			template<typename, typename>
+			friend class basic_iterator;
+			friend class ring_buffer;
+
+			ring_buffer_t* buffer_{};
+			size_t index_{};
+		};
+
+		using iterator = basic_iterator<ring_buffer, value_t>;
+		using const_iterator = basic_iterator<const ring_buffer, const value_t>;
+
+		explicit ring_buffer(size_t capacity = 0)
+		{
+			reserve(capacity);
+		}
+
+		void push_back(value_t&& value)
+		{
+			grow_if_full();
+			slots_[physical_index(size_)].emplace(std::move(value));
+			++size_;
+		}
+
+		void push_front(value_t&& value)
+		{
+			grow_if_full();
+			head_ = (head_ + slots_.size() - 1) % slots_.size();
+			slots_[head_].emplace(std::move(value));
+			++size_;
+		}
+
+		void pop_front()
+		{
+			slots_[head_].reset();
+			head_ = (head_ + 1) % slots_.size();
+			--size_;
+		}
+
+		void pop_back()
+		{
+			slots_[physical_index(size_ - 1)].reset();
+			--size_;
+		}
+
+		void clear()
+		{
+			while (!empty())
+			{
+				pop_back();
+			}
+			head_ = 0;
+		}
+
+		//Keeps the order of the elements
+		void reserve(size_t capacity)
+		{
+			if (capacity <= slots_.size())
+			{
+				return;
+			}
+
+			std::vector<std::optional<value_t>> slots(capacity);
+			for (size_t i = 0; i < size_; i++)
+			{
+				slots[i] = std::move(slots_[physical_index(i)]);
+			}
+
+			slots_ = std::move(slots);
+			head_ = 0;
+		}
+
+		iterator erase(const_iterator it)
+		{
+			size_t index = it.index_;
+			for (size_t i = index; i + 1 < size_; i++)
+			{
+				(*this)[i] = std::move((*this)[i + 1]);
+			}
+			pop_back();
+
+			return iterator(this, index);
+		}
+
+		value_t& operator[](size_t index)
+		{
+			return *slots_[physical_index(index)];
+		}
+
+		const value_t& operator[](size_t index) const
+		{
+			return *slots_[physical_index(index)];
+		}
+
+		value_t& at(size_t index)
+		{
+			if (index >= size_)
+			{
+				throw std::out_of_range("ring_buffer index out of range");
+			}
+			return (*this)[index];
+		}
+
+		const value_t& at(size_t index) const
+		{
+			if (index >= size_)
+			{
+				throw std::out_of_range("ring_buffer index out of range");
+			}
+			return (*this)[index];
+		}
+
+		value_t& front()
+		{
+			return (*this)[0];
+		}
+
+		const value_t& front() const
+		{
+			return (*this)[0];
+		}
+
+		value_t& back()
+		{
+			return (*this)[size_ - 1];
+		}
+
+		const value_t& back() const
+		{
+			return (*this)[size_ - 1];
+		}
+
+		size_t size() const
+		{
+			return size_;
+		}
+
+		size_t capacity() const
+		{
+			return slots_.size();
+		}
+
+		bool empty() const
+		{
+			return size_ == 0;
+		}
+
+		iterator begin()
+		{
+			return iterator(this, 0);
+		}
+
+		const_iterator begin() const
+		{
+			return const_iterator(this, 0);
+		}
+
+		const_iterator cbegin() const
+		{
+			return begin();
+		}
+
+		iterator end()
+		{
+			return iterator(this, size_);
+		}
+
+		const_iterator end() const
+		{
+			return const_iterator(this, size_);
+		}
+
+		const_iterator cend() const
+		{
+			return end();
+		}
+
+	private:
+		std::vector<std::optional<value_t>> slots_;
+		size_t head_{};
+		size_t size_{};
+
+		size_t physical_index(size_t index) const
+		{
+			return (head_ + index) % slots_.size();
+		}
+
+		void grow_if_full()
+		{
+			if (size_ == slots_.size())
+			{
+				reserve(slots_.empty() ? 16 : slots_.size() * 2);
+			}
+		}
+	};
+}
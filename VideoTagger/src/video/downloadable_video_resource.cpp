@@ -6,19 +6,6 @@
 
 namespace vt
 {
-	bool video_download_result::is_done() const
-	{
-		return result.wait_for(std::chrono::seconds{ 0 }) == std::future_status::ready;
-	}
-
-	void video_download_result::cancel()
-	{
-		if (data != nullptr)
-		{
-			data->cancel = true;
-		}
-	}
-
 	downloadable_video_resource::downloadable_video_resource(std::string importer_id, video_id_t id, video_resource_metadata metadata) :
 		video_resource(std::move(importer_id), std::move(id), std::move(metadata))
 	{
@@ -29,17 +16,17 @@ namespace vt
 	{
 	}
 
-	video_download_result downloadable_video_resource::download_task()
+	video_download_task downloadable_video_resource::download_task(utils::cancellation_token token)
 	{
-		video_download_result result;
+		video_download_task result;
 		result.data = std::make_shared<video_download_data>();
+		result.data->token = std::move(token);
 
-		auto task = [this](std::shared_ptr<video_download_data> data)
+		result.function = [this, data = result.data]()
 		{
 			return on_download(data);
 		};
 
-		result.result = std::async(std::launch::async, task, result.data);
 		download_data_ = result.data;
 		return result;
 	}
@@ -122,15 +109,9 @@ namespace vt
 		{
 			video_resource_context_menu_item item;
 			item.name = fmt::format("{} Cancel Download", icons::download_off);
-			item.function = [this]()
+			item.function = [id = id()]()
 			{
-				auto ptr = download_data_.lock();
-				if (ptr == nullptr)
-				{
-					return;
-				}
-
-				ptr->cancel = true;
+				ctx_.current_project->cancel_video_job(id, video_job_type::download);
 			};
 			items.push_back(std::move(item));
 		}
@@ -138,6 +119,8 @@ namespace vt
 
 	void downloadable_video_resource::icon_custom_draw(ImDrawList& draw_list, ImRect item_rect, ImRect image_rect) const
 	{
+		video_resource::icon_custom_draw(draw_list, item_rect, image_rect);
+
 		auto& style = ImGui::GetStyle();
 
 		if (!playable())
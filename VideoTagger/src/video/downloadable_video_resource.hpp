@@ -1,5 +1,5 @@
 #pragma once
-#include <future>
+#include <functional>
 #include <memory>
 #include <filesystem>
 #include <string>
@@ -24,18 +24,16 @@ namespace vt
 
 	struct video_download_data
 	{
-		bool cancel = false;
+		utils::cancellation_token token;
 		float progress = 0.f;
 		std::filesystem::path download_path;
 	};
 
-	struct video_download_result
+	struct video_download_task
 	{
 		std::shared_ptr<video_download_data> data;
-		std::future<video_download_status> result;
-
-		bool is_done() const;
-		void cancel();
+		//Runs on ctx_.jobs and uses the resource, so it must finish before the resource is destroyed
+		std::function<video_download_status()> function;
 	};
 
 	class downloadable_video_resource : public video_resource
@@ -45,8 +43,8 @@ namespace vt
 		downloadable_video_resource(std::string importer_id, const nlohmann::ordered_json& json);
 		virtual ~downloadable_video_resource() = default;
 
-		//local_path must be updated manually
-		video_download_result download_task();
+		//local_path must be updated manually, the download stops once the token is cancelled
+		video_download_task download_task(utils::cancellation_token token);
 		std::optional<float> download_progress() const;
 
 		bool remove_downloaded_file();
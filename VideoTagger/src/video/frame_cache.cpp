@@ -0,0 +1,153 @@
+#include "pch.hpp"
+#include "frame_cache.hpp"
+
+extern "C"
+{
+	#include <libavutil/imgutils.h>
+}
+
+namespace vt
+{
+	frame_cache::frame_cache(size_t budget_bytes, object_pool<video_frame>* frame_pool) : frame_pool_{ frame_pool }, budget_{ budget_bytes }
+	{
+	}
+
+	void frame_cache::set_budget(size_t budget_bytes)
+	{
+		std::unique_lock lock(mutex_);
+		budget_ = budget_bytes;
+		evict(budget_);
+	}
+
+	void frame_cache::insert(const video_frame& frame)
+	{
+		std::unique_lock lock(mutex_);
+		if (budget_ == 0)
+		{
+			return;
+		}
+
+		int frame_size = av_image_get_buffer_size(frame.pixel_format(), frame.width(), frame.height(), 1);
+		if (frame_size <= 0 or static_cast<size_t>(frame_size) > budget_)
+		{
+			return;
+		}
+
+		auto timestamp = frame.timestamp();
+		if (auto it = frames_.find(timestamp); it != frames_.end())
+		{
+			entries_.splice(entries_.begin(), entries_, it->second);
+			return;
+		}
+
+		evict(budget_ - frame_size);
+
+		if (!free_entries_.empty())
+		{
+			entries_.splice(entries_.begin(), free_entries_, free_entries_.begin());
+		}
+		else
+		{
+			entries_.emplace_front();
+		}
+
+		auto& entry = entries_.front();
+		entry.timestamp = timestamp;
+		entry.size = static_cast<size_t>(frame_size);
+		frame.make_reference(entry.frame);
+
+		if (!free_nodes_.empty())
+		{
+			auto node = std::move(free_nodes_.back());
+			free_nodes_.pop_back();
+			node.key() = timestamp;
+			node.mapped() = entries_.begin();
+			frames_.insert(std::move(node));
+		}
+		else
+		{
+			frames_.emplace(timestamp, entries_.begin());
+		}
+		size_ += frame_size;
+	}
+
+	std::optional<video_frame> frame_cache::find(std::chrono::nanoseconds timestamp, std::chrono::nanoseconds frame_time)
+	{
+		std::unique_lock lock(mutex_);
+
+		auto it = frames_.upper_bound(timestamp);
+		if (it != frames_.begin())
+		{
+			--it;
+
+			auto& frame = it->second->frame;
+			auto frame_duration = frame.duration() > std::chrono::nanoseconds{} ? frame.duration() : frame_time;
+			if (timestamp < it->first + frame_duration)
+			{
+				entries_.splice(entries_.begin(), entries_, it->second);
+				++hits_;
+
+				std::optional<video_frame> result = frame_pool_ != nullptr ? frame_pool_->acquire() : video_frame();
+				frame.make_reference(*result);
+				return result;
+			}
+		}
+
+		++misses_;
+		return std::nullopt;
+	}
+
+	std::optional<video_frame> frame_cache::find_nearest(std::chrono::nanoseconds timestamp)
+	{
+		std::unique_lock lock(mutex_);
+		if (frames_.empty())
+		{
+			return std::nullopt;
+		}
+
+		auto it = frames_.lower_bound(timestamp);
+		if (it == frames_.end() or (it != frames_.begin() and timestamp - std::prev(it)->first <= it->first - timestamp))
+		{
+			--it;
+		}
+
+		std::optional<video_frame> result = frame_pool_ != nullptr ? frame_pool_->acquire() : video_frame();
+		it->second->frame.make_reference(*result);
+		return result;
+	}
+
+	void frame_cache::clear()
+	{
+		std::unique_lock lock(mutex_);
+		frames_.clear();
+		entries_.clear();
+		free_entries_.clear();
+		free_nodes_.clear();
+		size_ = 0;
+	}
+
+	frame_cache_stats frame_cache::stats() const
+	{
+		std::unique_lock lock(mutex_);
+
+		frame_cache_stats result;
+		result.hits = hits_;
+		result.misses = misses_;
+		result.frame_count = entries_.size();
+		result.size_bytes = size_;
+		result.budget_bytes = budget_;
+		return result;
+	}
+
+	void frame_cache::evict(size_t budget_bytes)
+	{
+		while (size_ > budget_bytes and !entries_.empty())
+		{
+			auto& entry = entries_.back();
+			free_nodes_.push_back(frames_.extract(entry.timestamp));
+			size_ -= entry.size;
+			entry.frame.reset();
+			free_entries_.splice(free_entries_.begin(), entries_, std::prev(entries_.end()));
+		}
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "video_decoder.hpp"
+
+namespace vt
+{
+	struct frame_cache_stats
+	{
+		uint64_t hits{};
+		uint64_t misses{};
+		size_t frame_count{};
+		size_t size_bytes{};
+		size_t budget_bytes{};
+	};
+
+	//Keeps references to recently decoded frames, the least recently used frames are evicted when the budget is exceeded
+	class frame_cache
+	{
+	public:
+		//Frames returned by find are taken from the pool if it's not null
+		explicit frame_cache(size_t budget_bytes = 0, object_pool<video_frame>* frame_pool = nullptr);
+		frame_cache(const frame_cache&) = delete;
+		frame_cache(frame_cache&&) = delete;
+
+		frame_cache& operator=(const frame_cache&) = delete;
+		frame_cache& operator=(frame_cache&&) = delete;
+
+		//Budget of 0 disables the cache
+		void set_budget(size_t budget_bytes);
+
+		//Doesn't copy the pixels, the cached frame shares the buffers with the decoded one
+		void insert(const video_frame& frame);
+		//Returns the frame that is presented at the timestamp, frame_time is used for frames without a duration
+		[[nodiscard]] std::optional<video_frame> find(std::chrono::nanoseconds timestamp, std::chrono::nanoseconds frame_time);
+		//Returns the cached frame that is closest to the timestamp, used as a placeholder until the exact frame is decoded
+		[[nodiscard]] std::optional<video_frame> find_nearest(std::chrono::nanoseconds timestamp);
+		void clear();
+
+		[[nodiscard]] frame_cache_stats stats() const;
+
+	private:
+		struct cache_entry
+		{
+			std::chrono::nanoseconds timestamp{};
+			video_frame frame;
+			size_t size{};
+		};
+
+		using entry_list = std::list<cache_entry>;
+		using frame_map = std::map<std::chrono::nanoseconds, entry_list::iterator>;
+
+		mutable std::mutex mutex_;
+		//Most recently used first
+		entry_list entries_;
+		frame_map frames_;
+		// Evicted list and map nodes are kept so that inserting doesn't allocate once the cache is full
+		entry_list free_entries_;
+		std::vector<frame_map::node_type> free_nodes_;
+		object_pool<video_frame>* frame_pool_;
+		size_t budget_;
+		size_t size_{};
+
+		uint64_t hits_{};
+		uint64_t misses_{};
+
+		void evict(size_t budget_bytes);
+	};
+}
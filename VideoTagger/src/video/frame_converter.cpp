@@ -9,33 +9,80 @@ namespace vt
 	frame_converter::frame_converter(int frame_width, int frame_height, AVPixelFormat frame_format, int destination_width, int destination_height) :
 		frame_converter(frame_width, frame_height, frame_format, destination_width, destination_height, frame_format) {}
 
-	frame_converter::frame_converter(int frame_width, int frame_height, AVPixelFormat frame_format, int destination_width, int destination_height, AVPixelFormat destination_format) :
+	frame_converter::frame_converter(int frame_width, int frame_height, AVPixelFormat frame_format, int destination_width, int destination_height, AVPixelFormat destination_format, int thread_count) :
 		context_{}, source_width_{ frame_width }, source_height_{ frame_height }, source_format_{ frame_format },
-		destination_width_{ destination_width }, destination_height_{ destination_height }, destination_format_{ destination_format }
+		destination_width_{ destination_width }, destination_height_{ destination_height }, destination_format_{ destination_format },
+		thread_count_{ std::clamp(thread_count, 1, max_thread_count) }
 	{
-		context_ = sws_getContext(frame_width, frame_height, frame_format, destination_width, destination_height, destination_format, SWS_BILINEAR, nullptr, nullptr, nullptr);
+		int pixel_size = std::max(av_get_padded_bits_per_pixel(av_pix_fmt_desc_get(destination_format)) / 8, 1);
+		int linesize = destination_width * pixel_size;
+		destination_stride_ = (linesize + stride_alignment - 1) / stride_alignment * stride_alignment;
+		destination_row_length_ = destination_stride_ / pixel_size;
+
+		// swscale splits the frame into slices and converts them on its own threads
+		context_ = sws_alloc_context();
+		if (context_ == nullptr)
+		{
+			return;
+		}
+
+		av_opt_set_int(context_, "srcw", frame_width, 0);
+		av_opt_set_int(context_, "srch", frame_height, 0);
+		av_opt_set_pixel_fmt(context_, "src_format", frame_format, 0);
+		av_opt_set_int(context_, "dstw", destination_width, 0);
+		av_opt_set_int(context_, "dsth", destination_height, 0);
+		av_opt_set_pixel_fmt(context_, "dst_format", destination_format, 0);
+		av_opt_set_int(context_, "sws_flags", SWS_BILINEAR, 0);
+		av_opt_set_int(context_, "threads", thread_count_, 0);
 
 		//TODO: probably should throw if context_ is nullptr
+		if (sws_init_context(context_, nullptr, nullptr) < 0)
+		{
+			sws_freeContext(context_);
+			context_ = nullptr;
+		}
 	}
 
 	frame_converter::frame_converter(frame_converter&& other) noexcept :
 		context_{ other.context_ }, source_width_{ other.source_width_ }, source_height_{ other.source_height_ }, source_format_{ other.source_format_ },
-		destination_width_{ other.destination_width_ }, destination_height_{ other.destination_height_ }, destination_format_{ other.destination_format_ }
+		destination_width_{ other.destination_width_ }, destination_height_{ other.destination_height_ }, destination_format_{ other.destination_format_ },
+		destination_stride_{ other.destination_stride_ }, destination_row_length_{ other.destination_row_length_ }, thread_count_{ other.thread_count_ },
+		destination_frame_{ other.destination_frame_ }
 	{
 		other.context_ = nullptr;
+		other.destination_frame_ = nullptr;
 	}
 
 	frame_converter::~frame_converter()
 	{
 		sws_freeContext(context_);
+		av_frame_free(&destination_frame_);
 	}
 
 	frame_converter& frame_converter::operator=(frame_converter&& other) noexcept
 	{
+		if (this == &other)
+		{
+			return *this;
+		}
+
 		sws_freeContext(context_);
+		av_frame_free(&destination_frame_);
 
 		context_ = other.context_;
+		source_width_ = other.source_width_;
+		source_height_ = other.source_height_;
+		source_format_ = other.source_format_;
+		destination_width_ = other.destination_width_;
+		destination_height_ = other.destination_height_;
+		destination_format_ = other.destination_format_;
+		destination_stride_ = other.destination_stride_;
+		destination_row_length_ = other.destination_row_length_;
+		thread_count_ = other.thread_count_;
+		destination_frame_ = other.destination_frame_;
+
 		other.context_ = nullptr;
+		other.destination_frame_ = nullptr;
 
 		return *this;
 	}
@@ -44,36 +91,76 @@ namespace vt
 	{
 		//TODO: handle other formats
 
-		int original_linesizes[AV_NUM_DATA_POINTERS];
-		av_image_fill_linesizes(original_linesizes, destination_format_, destination_width_);
-
-		int strides[AV_NUM_DATA_POINTERS];
-		// stride must be multiple of 8 otherwise the image is cut off
-		strides[0] = ((original_linesizes[0] - 1) | 7) + 1;
-		size_t destination_size = strides[0] * destination_height_;
-
+		size_t destination_size = static_cast<size_t>(destination_stride_) * destination_height_;
 		if (data.size() != destination_size)
 		{
 			data.resize(destination_size);
 		}
 
+		if (context_ == nullptr)
+		{
+			return;
+		}
+
 		const AVFrame* av_frame = frame.unwrapped();
-		
-		std::fill(data.begin(), data.end(), 0xaa);
-		uint8_t* result[AV_NUM_DATA_POINTERS] = { data.data() };
-		
-		sws_scale(context_, av_frame->data, av_frame->linesize, 0, source_height_, result, strides);
-
-		// move the pixels to remove the padding
-		if (strides[0] != original_linesizes[0])
+		if (thread_count_ == 1)
+		{
+			// Without slice threads the planes are passed directly, so nothing is allocated per frame
+			uint8_t* destination_data[4] = { data.data(), nullptr, nullptr, nullptr };
+			int destination_linesize[4] = { destination_stride_, 0, 0, 0 };
+			sws_scale(context_, av_frame->data, av_frame->linesize, 0, source_height_, destination_data, destination_linesize);
+			return;
+		}
+
+		if (!wrap_destination(data))
 		{
-			for (size_t h = 0; h < destination_height_; h++)
+			return;
+		}
+
+		// Converting the whole frame in one call lets swscale use all of its slice threads
+		if (sws_frame_start(context_, destination_frame_, av_frame) >= 0)
+		{
+			if (sws_send_slice(context_, 0, source_height_) >= 0)
 			{
-				std::memmove(result[0] + h * original_linesizes[0], result[0] + h * strides[0], original_linesizes[0]);
+				sws_receive_slice(context_, 0, destination_height_);
 			}
+			sws_frame_end(context_);
 		}
 	}
 
+	bool frame_converter::wrap_destination(std::vector<uint8_t>& data)
+	{
+		if (destination_frame_ == nullptr)
+		{
+			destination_frame_ = av_frame_alloc();
+			if (destination_frame_ == nullptr)
+			{
+				return false;
+			}
+		}
+
+		auto buffer = destination_frame_->buf[0];
+		if (buffer != nullptr and buffer->data == data.data() and buffer->size == data.size())
+		{
+			return true;
+		}
+
+		// The frame has to be reference counted for swscale, but the memory belongs to data
+		av_frame_unref(destination_frame_);
+		destination_frame_->buf[0] = av_buffer_create(data.data(), data.size(), [](void*, uint8_t*) {}, nullptr, 0);
+		if (destination_frame_->buf[0] == nullptr)
+		{
+			return false;
+		}
+
+		destination_frame_->data[0] = data.data();
+		destination_frame_->linesize[0] = destination_stride_;
+		destination_frame_->width = destination_width_;
+		destination_frame_->height = destination_height_;
+		destination_frame_->format = destination_format_;
+		return true;
+	}
+
 	int frame_converter::source_width() const
 	{
 		return source_width_;
@@ -103,4 +190,19 @@ namespace vt
 	{
 		return destination_format_;
 	}
+
+	int frame_converter::destination_stride() const
+	{
+		return destination_stride_;
+	}
+
+	int frame_converter::destination_row_length() const
+	{
+		return destination_row_length_;
+	}
+
+	int frame_converter::thread_count() const
+	{
+		return thread_count_;
+	}
 }
@@ -5,6 +5,7 @@
 extern "C"
 {
 	#include <libavutil/imgutils.h>
+	#include <libavutil/opt.h>
 	#include <libswscale/swscale.h>
 }
 #include "video_decoder.hpp"
@@ -15,9 +16,15 @@ namespace vt
 	class frame_converter
 	{
 	public:
+		//Rows of the converted image start at multiples of this, it also has to be a multiple of the pixel size so the row length can be given to OpenGL
+		static constexpr int stride_alignment = 48;
+		//More slices don't pay off for the frame sizes that are displayed
+		static constexpr int max_thread_count = 4;
+
 		frame_converter(int frame_width, int frame_height, AVPixelFormat frame_format, AVPixelFormat destination_format);
 		frame_converter(int frame_width, int frame_height, AVPixelFormat frame_format, int destination_width, int destination_height);
-		frame_converter(int frame_width, int frame_height, AVPixelFormat frame_format, int destination_width, int destination_height, AVPixelFormat destination_format);
+		//With a thread count of 1 the frames are converted on the calling thread, otherwise swscale starts its own threads
+		frame_converter(int frame_width, int frame_height, AVPixelFormat frame_format, int destination_width, int destination_height, AVPixelFormat destination_format, int thread_count = 1);
 		frame_converter(const frame_converter&) = delete;
 		frame_converter(frame_converter&& other) noexcept;
 		~frame_converter();
@@ -27,6 +34,8 @@ namespace vt
 
 		//TODO: when video_frame is more generic make this return video_frame
 		// for now only works for converting to rgb24
+		// Rows are destination_stride() bytes apart, with more than one thread the image is split into slices that are converted in parallel
+		// With one thread it doesn't allocate, the threaded path only lets swscale reference the frames
 		void convert_frame(const video_frame& frame, std::vector<uint8_t>& data);
 
 		int source_width() const;
@@ -35,6 +44,11 @@ namespace vt
 		int destination_width() const;
 		int destination_height() const;
 		AVPixelFormat destination_format() const;
+		//Size of a row of the converted image in bytes
+		int destination_stride() const;
+		//Same as destination_stride but in pixels, can be used as GL_UNPACK_ROW_LENGTH
+		int destination_row_length() const;
+		int thread_count() const;
 
 	private:
 		SwsContext* context_;
@@ -42,5 +56,12 @@ namespace vt
 		AVPixelFormat source_format_;
 		int destination_width_, destination_height_;
 		AVPixelFormat destination_format_;
+		int destination_stride_{};
+		int destination_row_length_{};
+		int thread_count_{};
+		//Used by the threaded path, it wraps the data of the last call and is only rewrapped when the data moves
+		AVFrame* destination_frame_{};
+
+		[[nodiscard]] bool wrap_destination(std::vector<uint8_t>& data);
 	};
 }
@@ -0,0 +1,283 @@
+#include "pch.hpp"
+#include "frame_index.hpp"
+
+extern "C"
+{
+	#include <libavcodec/avcodec.h>
+	#include <libavformat/avformat.h>
+}
+
+namespace vt
+{
+	static constexpr std::array<char, 4> frame_index_magic = { 'V', 'T', 'F', 'I' };
+
+	frame_index::frame_index(std::vector<frame_index_entry> entries, int stream_index, int time_base_num, int time_base_den) :
+		entries_{ std::move(entries) }, stream_index_{ stream_index }, time_base_num_{ time_base_num }, time_base_den_{ time_base_den }
+	{
+		std::sort(entries_.begin(), entries_.end(), [](const frame_index_entry& lhs, const frame_index_entry& rhs)
+		{
+			return lhs.pts < rhs.pts;
+		});
+
+		for (size_t i = 0; i < entries_.size(); i++)
+		{
+			if (entries_[i].keyframe)
+			{
+				keyframes_.push_back(i);
+			}
+		}
+	}
+
+	std::optional<frame_index> frame_index::build(const std::filesystem::path& video_path, const utils::cancellation_token& token)
+	{
+		AVFormatContext* format_context = nullptr;
+		if (avformat_open_input(&format_context, video_path.u8string().c_str(), nullptr, nullptr) < 0)
+		{
+			return std::nullopt;
+		}
+
+		if (avformat_find_stream_info(format_context, nullptr) < 0)
+		{
+			avformat_close_input(&format_context);
+			return std::nullopt;
+		}
+
+		// Same stream selection as video_decoder::open
+		int stream_index = -1;
+		for (unsigned int i = 0; i < format_context->nb_streams; i++)
+		{
+			auto codec_params = format_context->streams[i]->codecpar;
+			if (codec_params->codec_type == AVMEDIA_TYPE_VIDEO and avcodec_find_decoder(codec_params->codec_id) != nullptr)
+			{
+				stream_index = static_cast<int>(i);
+			}
+		}
+
+		AVPacket* packet = av_packet_alloc();
+		if (stream_index < 0 or packet == nullptr)
+		{
+			av_packet_free(&packet);
+			avformat_close_input(&format_context);
+			return std::nullopt;
+		}
+
+		auto stream = format_context->streams[stream_index];
+
+		std::vector<frame_index_entry> entries;
+		if (stream->nb_frames > 0)
+		{
+			entries.reserve(static_cast<size_t>(stream->nb_frames));
+		}
+
+		// The progress is estimated from the position in the file, it's unknown for streams without a size
+		int64_t file_size = format_context->pb != nullptr ? avio_size(format_context->pb) : -1;
+		while (!token.is_cancelled() and av_read_frame(format_context, packet) >= 0)
+		{
+			if (file_size > 0 and packet->pos >= 0)
+			{
+				token.set_progress(static_cast<float>(static_cast<double>(packet->pos) / file_size));
+			}
+
+			if (packet->stream_index == stream_index)
+			{
+				int64_t pts = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+				if (pts != AV_NOPTS_VALUE)
+				{
+					frame_index_entry entry;
+					entry.pts = pts;
+					entry.position = packet->pos;
+					entry.keyframe = (packet->flags & AV_PKT_FLAG_KEY) != 0;
+					entries.push_back(entry);
+				}
+			}
+			av_packet_unref(packet);
+		}
+
+		// The stream is freed together with the format context
+		auto time_base = stream->time_base;
+		av_packet_free(&packet);
+		avformat_close_input(&format_context);
+
+		// A partial index would make seeking miss the frames after the point where it stopped
+		if (token.is_cancelled())
+		{
+			return std::nullopt;
+		}
+
+		frame_index result(std::move(entries), stream_index, time_base.num, time_base.den);
+
+		if (result.empty())
+		{
+			return std::nullopt;
+		}
+
+		return result;
+	}
+
+	std::optional<frame_index> frame_index::load(const std::filesystem::path& filepath)
+	{
+		std::ifstream file(filepath, std::ios::binary);
+		if (!file.is_open())
+		{
+			return std::nullopt;
+		}
+
+		std::array<char, 4> magic{};
+		uint32_t version{};
+		int32_t stream_index{};
+		int32_t time_base_num{};
+		int32_t time_base_den{};
+		uint64_t count{};
+
+		file.read(magic.data(), magic.size());
+		file.read(reinterpret_cast<char*>(&version), sizeof(version));
+		file.read(reinterpret_cast<char*>(&stream_index), sizeof(stream_index));
+		file.read(reinterpret_cast<char*>(&time_base_num), sizeof(time_base_num));
+		file.read(reinterpret_cast<char*>(&time_base_den), sizeof(time_base_den));
+		file.read(reinterpret_cast<char*>(&count), sizeof(count));
+
+		if (!file or magic != frame_index_magic or version != file_version or time_base_den == 0)
+		{
+			return std::nullopt;
+		}
+
+		// The count is checked against the rest of the file, so a corrupt one can't make it allocate a huge vector
+		constexpr uint64_t stored_entry_size = sizeof(frame_index_entry::pts) + sizeof(frame_index_entry::position) + sizeof(uint8_t);
+		std::error_code error;
+		uint64_t file_size = std::filesystem::file_size(filepath, error);
+		uint64_t header_size = static_cast<uint64_t>(file.tellg());
+		if (error or file_size < header_size or count > (file_size - header_size) / stored_entry_size)
+		{
+			return std::nullopt;
+		}
+
+		std::vector<frame_index_entry> entries(count);
+		for (auto& entry : entries)
+		{
+			uint8_t keyframe{};
+			file.read(reinterpret_cast<char*>(&entry.pts), sizeof(entry.pts));
+			file.read(reinterpret_cast<char*>(&entry.position), sizeof(entry.position));
+			file.read(reinterpret_cast<char*>(&keyframe), sizeof(keyframe));
+			entry.keyframe = keyframe != 0;
+		}
+
+		if (!file)
+		{
+			return std::nullopt;
+		}
+
+		return frame_index(std::move(entries), stream_index, time_base_num, time_base_den);
+	}
+
+	bool frame_index::save(const std::filesystem::path& filepath) const
+	{
+		if (filepath.has_parent_path())
+		{
+			std::error_code error;
+			std::filesystem::create_directories(filepath.parent_path(), error);
+		}
+
+		std::ofstream file(filepath, std::ios::binary);
+		if (!file.is_open())
+		{
+			return false;
+		}
+
+		uint32_t version = file_version;
+		int32_t stream_index = stream_index_;
+		int32_t time_base_num = time_base_num_;
+		int32_t time_base_den = time_base_den_;
+		uint64_t count = entries_.size();
+
+		file.write(frame_index_magic.data(), frame_index_magic.size());
+		file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+		file.write(reinterpret_cast<const char*>(&stream_index), sizeof(stream_index));
+		file.write(reinterpret_cast<const char*>(&time_base_num), sizeof(time_base_num));
+		file.write(reinterpret_cast<const char*>(&time_base_den), sizeof(time_base_den));
+		file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+
+		for (auto& entry : entries_)
+		{
+			uint8_t keyframe = entry.keyframe ? 1 : 0;
+			file.write(reinterpret_cast<const char*>(&entry.pts), sizeof(entry.pts));
+			file.write(reinterpret_cast<const char*>(&entry.position), sizeof(entry.position));
+			file.write(reinterpret_cast<const char*>(&keyframe), sizeof(keyframe));
+		}
+
+		return static_cast<bool>(file);
+	}
+
+	const frame_index_entry& frame_index::at(size_t frame_number) const
+	{
+		return entries_.at(frame_number);
+	}
+
+	size_t frame_index::size() const
+	{
+		return entries_.size();
+	}
+
+	bool frame_index::empty() const
+	{
+		return entries_.empty();
+	}
+
+	int frame_index::stream_index() const
+	{
+		return stream_index_;
+	}
+
+	int frame_index::time_base_num() const
+	{
+		return time_base_num_;
+	}
+
+	int frame_index::time_base_den() const
+	{
+		return time_base_den_;
+	}
+
+	std::chrono::nanoseconds frame_index::timestamp(size_t frame_number) const
+	{
+		if (entries_.empty())
+		{
+			return std::chrono::nanoseconds{};
+		}
+
+		frame_number = std::min(frame_number, entries_.size() - 1);
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(entries_[frame_number].pts * av_q2d({ time_base_num_, time_base_den_ })));
+	}
+
+	size_t frame_index::frame_number(std::chrono::nanoseconds timestamp) const
+	{
+		if (entries_.empty())
+		{
+			return 0;
+		}
+
+		// Rounded to the nearest tick, timestamps made by timestamp() are truncated to nanoseconds
+		auto pts = std::llround(std::chrono::duration_cast<std::chrono::duration<double>>(timestamp).count() / av_q2d({ time_base_num_, time_base_den_ }));
+		auto it = std::upper_bound(entries_.begin(), entries_.end(), pts, [](int64_t value, const frame_index_entry& entry)
+		{
+			return value < entry.pts;
+		});
+
+		if (it == entries_.begin())
+		{
+			return 0;
+		}
+
+		return static_cast<size_t>(std::distance(entries_.begin(), it)) - 1;
+	}
+
+	size_t frame_index::keyframe_before(size_t frame_number) const
+	{
+		auto it = std::upper_bound(keyframes_.begin(), keyframes_.end(), frame_number);
+		if (it == keyframes_.begin())
+		{
+			return 0;
+		}
+
+		return *(it - 1);
+	}
+}
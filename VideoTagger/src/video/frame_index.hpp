@@ -0,0 +1,56 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+#include <utils/job_scheduler.hpp>
+
+namespace vt
+{
+	struct frame_index_entry
+	{
+		int64_t pts{};
+		//Byte position of the packet in the file, -1 if unknown
+		int64_t position = -1;
+		bool keyframe{};
+	};
+
+	//Table of every frame of a video stream in presentation order
+	class frame_index
+	{
+	public:
+		static constexpr uint32_t file_version = 1;
+		static constexpr const char* extension = "vtfi";
+
+		frame_index() = default;
+		frame_index(std::vector<frame_index_entry> entries, int stream_index, int time_base_num, int time_base_den);
+
+		//Demuxes the whole file without decoding it
+		//Returns nullopt if the token is cancelled, it's checked after every packet
+		[[nodiscard]] static std::optional<frame_index> build(const std::filesystem::path& video_path, const utils::cancellation_token& token = {});
+		[[nodiscard]] static std::optional<frame_index> load(const std::filesystem::path& filepath);
+		bool save(const std::filesystem::path& filepath) const;
+
+		[[nodiscard]] const frame_index_entry& at(size_t frame_number) const;
+		[[nodiscard]] size_t size() const;
+		[[nodiscard]] bool empty() const;
+
+		[[nodiscard]] int stream_index() const;
+		[[nodiscard]] int time_base_num() const;
+		[[nodiscard]] int time_base_den() const;
+
+		[[nodiscard]] std::chrono::nanoseconds timestamp(size_t frame_number) const;
+		//Returns the last frame presented at or before the timestamp
+		[[nodiscard]] size_t frame_number(std::chrono::nanoseconds timestamp) const;
+		//Returns the last keyframe at or before the frame
+		[[nodiscard]] size_t keyframe_before(size_t frame_number) const;
+
+	private:
+		std::vector<frame_index_entry> entries_;
+		std::vector<size_t> keyframes_;
+		int stream_index_ = -1;
+		int time_base_num_ = 1;
+		int time_base_den_ = 1;
+	};
+}
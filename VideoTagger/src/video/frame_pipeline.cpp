@@ -0,0 +1,574 @@
+#include "pch.hpp"
+#include "frame_pipeline.hpp"
+
+namespace vt
+{
+	frame_pipeline::frame_pipeline(video_decoder& decoder, size_t capacity) : decoder_{ &decoder }, frames_(std::max<size_t>(capacity, 1)), capacity_{ std::max<size_t>(capacity, 1) }
+	{
+		stats_.queue_capacity = capacity_;
+		stats_.frame_queue_slots = frames_.capacity();
+		// One extra buffer for the frame that is being converted and one for the frame that is displayed
+		spare_pixels_.reserve(capacity_ + 2);
+	}
+
+	frame_pipeline::~frame_pipeline()
+	{
+		stop();
+	}
+
+	void frame_pipeline::start()
+	{
+		std::unique_lock lock(mutex_);
+		if (running_)
+		{
+			// A worker that was started for a seek keeps decoding after it
+			seek_only_ = false;
+			return;
+		}
+
+		if (eof_)
+		{
+			return;
+		}
+		lock.unlock();
+
+		if (thread_.joinable())
+		{
+			thread_.join();
+		}
+
+		lock.lock();
+		stop_requested_ = false;
+		seek_only_ = false;
+		running_ = true;
+		lock.unlock();
+
+		thread_ = std::thread(&frame_pipeline::run, this);
+	}
+
+	void frame_pipeline::stop()
+	{
+		if (!thread_.joinable())
+		{
+			return;
+		}
+
+		{
+			std::unique_lock lock(mutex_);
+			stop_requested_ = true;
+		}
+		condition_.notify_all();
+
+		thread_.join();
+	}
+
+	void frame_pipeline::pause()
+	{
+		{
+			std::unique_lock lock(mutex_);
+			seek_only_ = true;
+		}
+		condition_.notify_all();
+	}
+
+	void frame_pipeline::flush()
+	{
+		std::unique_lock lock(mutex_);
+		clear_queue();
+		seek_target_.reset();
+		seeking_ = false;
+		decoder_timestamp_.reset();
+	}
+
+	void frame_pipeline::request_seek(std::chrono::nanoseconds target_timestamp)
+	{
+		std::unique_lock lock(mutex_);
+		seek_target_ = target_timestamp;
+		seeking_ = true;
+		clear_queue();
+
+		if (running_)
+		{
+			lock.unlock();
+			condition_.notify_all();
+			return;
+		}
+
+		stop_requested_ = false;
+		seek_only_ = true;
+		running_ = true;
+		lock.unlock();
+
+		// The previous worker already decided to stop, it only has to be joined
+		if (thread_.joinable())
+		{
+			thread_.join();
+		}
+		thread_ = std::thread(&frame_pipeline::run, this);
+	}
+
+	bool frame_pipeline::seeking() const
+	{
+		std::unique_lock lock(mutex_);
+		return seeking_;
+	}
+
+	void frame_pipeline::set_decoder(video_decoder& decoder)
+	{
+		decoder_ = &decoder;
+	}
+
+	void frame_pipeline::set_frame_cache(frame_cache* cache)
+	{
+		frame_cache_ = cache;
+	}
+
+	void frame_pipeline::set_output_size(int width, int height)
+	{
+		std::unique_lock lock(mutex_);
+		output_width_ = width;
+		output_height_ = height;
+	}
+
+	void frame_pipeline::set_scale_thread_count(int count)
+	{
+		std::unique_lock lock(mutex_);
+		scale_thread_count_ = std::max(count, 1);
+	}
+
+	std::optional<pipeline_frame> frame_pipeline::take_frame(std::chrono::nanoseconds target_timestamp)
+	{
+		std::optional<pipeline_frame> result;
+
+		{
+			std::unique_lock lock(mutex_);
+			target_timestamp_ = target_timestamp;
+			while (!frames_.empty() and frames_.front().frame.timestamp() <= target_timestamp)
+			{
+				if (result.has_value())
+				{
+					recycle(std::move(*result));
+					++stats_.dropped_frames;
+				}
+				result = std::move(frames_.front());
+				frames_.pop_front();
+			}
+
+			if (!result.has_value() and frames_.empty() and !eof_)
+			{
+				++stats_.consumer_stalls;
+			}
+			stats_.queue_depth = frames_.size();
+		}
+
+		if (result.has_value())
+		{
+			condition_.notify_all();
+		}
+
+		return result;
+	}
+
+	void frame_pipeline::push_frame(video_frame&& frame)
+	{
+		decoder_timestamp_ = frame.timestamp();
+
+		std::unique_lock lock(mutex_);
+		frames_.push_back(pipeline_frame{ std::move(frame), {}, 0, 0, 0 });
+		stats_.queue_depth = frames_.size();
+		stats_.frame_queue_slots = frames_.capacity();
+	}
+
+	void frame_pipeline::recycle_pixels(std::vector<uint8_t>&& pixels)
+	{
+		std::unique_lock lock(mutex_);
+		if (spare_pixels_.size() < spare_pixels_.capacity())
+		{
+			spare_pixels_.push_back(std::move(pixels));
+		}
+	}
+
+	size_t frame_pipeline::queue_size() const
+	{
+		std::unique_lock lock(mutex_);
+		return frames_.size();
+	}
+
+	bool frame_pipeline::is_running() const
+	{
+		std::unique_lock lock(mutex_);
+		return running_;
+	}
+
+	bool frame_pipeline::finished() const
+	{
+		std::unique_lock lock(mutex_);
+		return eof_ and frames_.empty();
+	}
+
+	frame_pipeline_stats frame_pipeline::stats() const
+	{
+		std::unique_lock lock(mutex_);
+		return stats_;
+	}
+
+	void frame_pipeline::run()
+	{
+		auto default_frame_duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(1.0 / decoder_->fps()));
+
+		while (true)
+		{
+			std::optional<std::chrono::nanoseconds> seek_target;
+
+			{
+				std::unique_lock lock(mutex_);
+				if (frames_.size() >= capacity_ and !stop_requested_ and !seek_only_ and !seek_target_.has_value())
+				{
+					++stats_.producer_stalls;
+					condition_.wait(lock, [this]() { return stop_requested_ or seek_only_ or seek_target_.has_value() or frames_.size() < capacity_; });
+				}
+
+				// Decided under the lock, so a seek requested after this starts a new worker
+				if (stop_requested_ or (seek_only_ and !seek_target_.has_value()))
+				{
+					stats_.catching_up = false;
+					running_ = false;
+					break;
+				}
+
+				if (seek_target_.has_value())
+				{
+					seek_target = seek_target_;
+					seek_target_.reset();
+					// Frames decoded before the request was noticed
+					clear_queue();
+				}
+			}
+
+			if (seek_target.has_value())
+			{
+				seek_decoder(*seek_target);
+				continue;
+			}
+
+			auto frame = decode_next_frame();
+			if (!frame.has_value())
+			{
+				std::unique_lock lock(mutex_);
+				if (seek_target_.has_value())
+				{
+					continue;
+				}
+
+				eof_ = true;
+				stats_.catching_up = false;
+				running_ = false;
+				break;
+			}
+
+			if (frame_cache_ != nullptr)
+			{
+				frame_cache_->insert(*frame);
+			}
+
+			auto frame_timestamp = frame->timestamp();
+			auto frame_duration = frame->duration() > std::chrono::nanoseconds{} ? frame->duration() : default_frame_duration;
+			std::optional<std::chrono::nanoseconds> target_timestamp;
+
+			{
+				std::unique_lock lock(mutex_);
+				target_timestamp = target_timestamp_;
+
+				// Frames that were skipped by the codec or by jumping to a keyframe
+				if (decoder_timestamp_.has_value() and frame_timestamp > *decoder_timestamp_)
+				{
+					auto skipped_frames = std::llround(static_cast<double>((frame_timestamp - *decoder_timestamp_).count()) / frame_duration.count()) - 1;
+					stats_.dropped_frames += static_cast<uint64_t>(std::max<int64_t>(skipped_frames, 0));
+				}
+			}
+			decoder_timestamp_ = frame_timestamp;
+
+			if (target_timestamp.has_value())
+			{
+				catch_up(frame_timestamp, frame_duration, *target_timestamp);
+
+				// The next frame is also older than the target so this one would never be displayed, no need to convert it
+				if (frame_timestamp + frame_duration <= *target_timestamp)
+				{
+					std::unique_lock lock(mutex_);
+					decoder_->recycle_frame(std::move(*frame));
+					++stats_.dropped_frames;
+					continue;
+				}
+			}
+
+			auto entry = make_entry(std::move(*frame));
+			auto packet_queue_slots = decoder_->packet_queue_capacity();
+
+			{
+				std::unique_lock lock(mutex_);
+				frames_.push_back(std::move(entry));
+				++stats_.decoded_frames;
+				stats_.queue_depth = frames_.size();
+				stats_.frame_queue_slots = frames_.capacity();
+				stats_.packet_queue_slots = packet_queue_slots;
+			}
+		}
+
+		if (skip_frame_ != AVDISCARD_DEFAULT)
+		{
+			skip_frame_ = AVDISCARD_DEFAULT;
+			decoder_->set_skip_frame(skip_frame_);
+		}
+		skip_to_keyframe_ = false;
+	}
+
+	void frame_pipeline::seek_decoder(std::chrono::nanoseconds target_timestamp)
+	{
+		if (skip_frame_ != AVDISCARD_DEFAULT)
+		{
+			skip_frame_ = AVDISCARD_DEFAULT;
+			decoder_->set_skip_frame(skip_frame_);
+		}
+		skip_to_keyframe_ = false;
+
+		// When scrubbing forward within a group of pictures it's faster to keep decoding than to go back to the keyframe
+		bool seek_keyframe = true;
+		auto index = decoder_->get_frame_index();
+		if (index != nullptr and decoder_timestamp_.has_value())
+		{
+			auto decoder_frame = index->frame_number(*decoder_timestamp_);
+			auto target_frame = index->frame_number(target_timestamp);
+			seek_keyframe = target_frame <= decoder_frame or index->keyframe_before(target_frame) > decoder_frame;
+		}
+
+		if (seek_keyframe)
+		{
+			decoder_->seek_keyframe(target_timestamp);
+			decoder_timestamp_.reset();
+		}
+
+		bool keyframes_only = decoder_->get_decode_mode().keyframes_only;
+		std::optional<video_frame> target_frame;
+		std::optional<video_frame> next_frame;
+		while (true)
+		{
+			{
+				std::unique_lock lock(mutex_);
+				if (stop_requested_ or seek_target_.has_value())
+				{
+					++stats_.cancelled_seeks;
+					if (target_frame.has_value())
+					{
+						decoder_->recycle_frame(std::move(*target_frame));
+					}
+					return;
+				}
+			}
+
+			auto frame = decode_next_frame();
+			if (!frame.has_value())
+			{
+				break;
+			}
+
+			if (frame_cache_ != nullptr)
+			{
+				frame_cache_->insert(*frame);
+			}
+			decoder_timestamp_ = frame->timestamp();
+
+			if (target_frame.has_value() and frame->timestamp() > target_timestamp)
+			{
+				next_frame = std::move(frame);
+				break;
+			}
+
+			if (target_frame.has_value())
+			{
+				decoder_->recycle_frame(std::move(*target_frame));
+			}
+			target_frame = std::move(frame);
+
+			// Decoding starts at the last keyframe before the target, so there's nothing closer
+			if (target_frame->timestamp() > target_timestamp or keyframes_only)
+			{
+				break;
+			}
+		}
+
+		std::optional<pipeline_frame> target_entry;
+		if (target_frame.has_value())
+		{
+			target_entry = make_entry(std::move(*target_frame));
+		}
+
+		std::unique_lock lock(mutex_);
+		if (seek_target_.has_value())
+		{
+			++stats_.cancelled_seeks;
+			if (target_entry.has_value())
+			{
+				recycle(std::move(*target_entry));
+			}
+			if (next_frame.has_value())
+			{
+				decoder_->recycle_frame(std::move(*next_frame));
+			}
+			return;
+		}
+
+		if (target_entry.has_value())
+		{
+			frames_.push_back(std::move(*target_entry));
+		}
+		// Only needed if playback continues, so it's converted later
+		if (next_frame.has_value())
+		{
+			frames_.push_back(pipeline_frame{ std::move(*next_frame), {}, 0, 0, 0 });
+		}
+		stats_.queue_depth = frames_.size();
+		stats_.frame_queue_slots = frames_.capacity();
+		seeking_ = false;
+	}
+
+	pipeline_frame frame_pipeline::make_entry(video_frame&& frame)
+	{
+		pipeline_frame entry{ std::move(frame), {}, 0, 0, 0 };
+		int output_width{};
+		int output_height{};
+		int scale_thread_count{};
+
+		{
+			std::unique_lock lock(mutex_);
+			output_width = output_width_;
+			output_height = output_height_;
+			scale_thread_count = scale_thread_count_;
+
+			if (!spare_pixels_.empty())
+			{
+				entry.pixels = std::move(spare_pixels_.back());
+				spare_pixels_.pop_back();
+			}
+		}
+
+		if (output_width > 0 and output_height > 0)
+		{
+			auto& decoded = entry.frame;
+			if (!converter_.has_value() or converter_->source_width() != decoded.width() or converter_->source_height() != decoded.height()
+				or converter_->source_format() != decoded.pixel_format() or converter_->destination_width() != output_width or converter_->destination_height() != output_height
+				or converter_->thread_count() != scale_thread_count)
+			{
+				converter_.emplace(decoded.width(), decoded.height(), decoded.pixel_format(), output_width, output_height, AV_PIX_FMT_RGB24, scale_thread_count);
+			}
+
+			converter_->convert_frame(decoded, entry.pixels);
+			entry.width = output_width;
+			entry.height = output_height;
+			entry.row_length = converter_->destination_row_length();
+		}
+
+		return entry;
+	}
+
+	void frame_pipeline::recycle(pipeline_frame&& frame)
+	{
+		decoder_->recycle_frame(std::move(frame.frame));
+		if (spare_pixels_.size() < spare_pixels_.capacity())
+		{
+			spare_pixels_.push_back(std::move(frame.pixels));
+		}
+	}
+
+	void frame_pipeline::clear_queue()
+	{
+		while (!frames_.empty())
+		{
+			recycle(std::move(frames_.front()));
+			frames_.pop_front();
+		}
+		eof_ = false;
+		target_timestamp_.reset();
+		stats_.queue_depth = 0;
+	}
+
+	void frame_pipeline::catch_up(std::chrono::nanoseconds frame_timestamp, std::chrono::nanoseconds frame_duration, std::chrono::nanoseconds target_timestamp)
+	{
+		auto lag = target_timestamp - frame_timestamp;
+
+		AVDiscard skip_frame = lag > frame_duration * skip_nonref_lag_frames ? AVDISCARD_NONREF : AVDISCARD_DEFAULT;
+		if (skip_frame != skip_frame_)
+		{
+			skip_frame_ = skip_frame;
+			decoder_->set_skip_frame(skip_frame_);
+		}
+
+		if (lag > keyframe_jump_lag and !skip_to_keyframe_)
+		{
+			auto index = decoder_->get_frame_index();
+			if (index != nullptr)
+			{
+				// Only jump if the keyframe is ahead of the decoder, otherwise it's faster to keep decoding
+				auto keyframe = index->keyframe_before(index->frame_number(target_timestamp));
+				if (keyframe > index->frame_number(frame_timestamp))
+				{
+					// If the jump fails the decoder is still in place and just keeps decoding towards the target
+					if (decoder_->seek_keyframe(keyframe))
+					{
+						std::unique_lock lock(mutex_);
+						++stats_.keyframe_jumps;
+					}
+				}
+			}
+			else
+			{
+				// Frames buffered in the codec and queued packets are older than the next keyframe
+				decoder_->discard_all_packets(stream_type::video);
+				decoder_->flush_codecs();
+				skip_to_keyframe_ = true;
+
+				std::unique_lock lock(mutex_);
+				++stats_.keyframe_jumps;
+			}
+		}
+
+		std::unique_lock lock(mutex_);
+		stats_.catching_up = skip_frame_ != AVDISCARD_DEFAULT or skip_to_keyframe_;
+	}
+
+	std::optional<video_frame> frame_pipeline::decode_next_frame()
+	{
+		while (!decoder_->drained())
+		{
+			auto frame = decoder_->receive_frame();
+			if (frame.has_value())
+			{
+				return frame;
+			}
+
+			if (decoder_->packet_queue_size(stream_type::video) == 0 and !decoder_->eof())
+			{
+				decoder_->read_packet();
+				if (!decoder_->eof())
+				{
+					if (decoder_->last_read_packet_type() != stream_type::video)
+					{
+						decoder_->discard_last_read_packet();
+						continue;
+					}
+
+					if (skip_to_keyframe_ and !decoder_->peek_last_read_packet().is_key())
+					{
+						decoder_->discard_last_read_packet();
+						continue;
+					}
+				}
+				skip_to_keyframe_ = false;
+			}
+
+			decoder_->send_next_packet();
+		}
+
+		return std::nullopt;
+	}
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <utils/ring_buffer.hpp>
+#include "video_decoder.hpp"
+#include "frame_converter.hpp"
+#include "frame_cache.hpp"
+
+namespace vt
+{
+	struct pipeline_frame
+	{
+		video_frame frame;
+		//Converted pixels, empty if the pipeline had no output size when the frame was decoded
+		std::vector<uint8_t> pixels;
+		int width{};
+		int height{};
+		//Distance between the rows of pixels, in pixels
+		int row_length{};
+	};
+
+	struct frame_pipeline_stats
+	{
+		size_t queue_depth{};
+		size_t queue_capacity{};
+		//Slots allocated by the frame queue and by the decoder's packet queues, they grow when a push finds them full and never shrink
+		size_t frame_queue_slots{};
+		size_t packet_queue_slots{};
+		uint64_t decoded_frames{};
+		//How many times the worker had to wait because the queue was full
+		uint64_t producer_stalls{};
+		//How many times a frame was requested but the worker didn't have one ready
+		uint64_t consumer_stalls{};
+		//Frames that were never displayed because the pipeline was behind
+		uint64_t dropped_frames{};
+		uint64_t keyframe_jumps{};
+		//Seeks that were replaced by a newer target before they finished
+		uint64_t cancelled_seeks{};
+		bool catching_up{};
+	};
+
+	//Reads, decodes and converts video frames on a background thread into a bounded queue
+	class frame_pipeline
+	{
+	public:
+		static constexpr size_t default_capacity = 8;
+		//Non-reference frames are skipped when the pipeline is behind by more frames than this
+		static constexpr int skip_nonref_lag_frames = 2;
+		//Decoding jumps to the next keyframe when the pipeline is behind by more than this
+		static constexpr std::chrono::milliseconds keyframe_jump_lag{ 500 };
+
+		explicit frame_pipeline(video_decoder& decoder, size_t capacity = default_capacity);
+		frame_pipeline(const frame_pipeline&) = delete;
+		frame_pipeline(frame_pipeline&&) = delete;
+		~frame_pipeline();
+
+		frame_pipeline& operator=(const frame_pipeline&) = delete;
+		frame_pipeline& operator=(frame_pipeline&&) = delete;
+
+		//Does nothing if the worker is already running or the decoder reached eof
+		void start();
+		//Blocks until the worker stops, after that the decoder can be safely used from the calling thread
+		//A seek that didn't finish is abandoned and the decoder is left somewhere before its target
+		void stop();
+		//Doesn't block, the worker stops after the pending seek or right away if there is none
+		void pause();
+		//Discards all queued frames, the pipeline must be stopped
+		void flush();
+
+		//Decodes the frame at the timestamp on the worker, a newer request cancels the one that is still being decoded
+		//When it's done the frame can be taken with take_frame(target_timestamp), the worker is started if it wasn't running
+		void request_seek(std::chrono::nanoseconds target_timestamp);
+		//True from request_seek until the frame of the last requested seek is queued
+		[[nodiscard]] bool seeking() const;
+		//The pipeline must be stopped
+		void set_decoder(video_decoder& decoder);
+		//Decoded frames will be inserted into the cache, the pipeline must be stopped
+		void set_frame_cache(frame_cache* cache);
+
+		//Frames decoded after this call will be converted to rgb24 with the given size
+		void set_output_size(int width, int height);
+		//Threads used to convert the frames decoded after this call, 1 converts them on the pipeline thread
+		void set_scale_thread_count(int count);
+
+		//Discards all frames that are older than the target timestamp and returns the newest of them
+		[[nodiscard]] std::optional<pipeline_frame> take_frame(std::chrono::nanoseconds target_timestamp);
+		//Queues a frame that was decoded outside of the pipeline, the pipeline must be stopped
+		void push_frame(video_frame&& frame);
+		//Gives a pixel buffer back to the pipeline so it can be reused for converting the next frames
+		void recycle_pixels(std::vector<uint8_t>&& pixels);
+
+		[[nodiscard]] size_t queue_size() const;
+		[[nodiscard]] bool is_running() const;
+		//Returns true when the decoder reached eof and all decoded frames were taken
+		[[nodiscard]] bool finished() const;
+		[[nodiscard]] frame_pipeline_stats stats() const;
+
+	private:
+		video_decoder* decoder_;
+		frame_cache* frame_cache_{};
+		std::thread thread_;
+		mutable std::mutex mutex_;
+		std::condition_variable condition_;
+
+		ring_buffer<pipeline_frame> frames_;
+		size_t capacity_;
+		std::vector<std::vector<uint8_t>> spare_pixels_;
+
+		int output_width_{};
+		int output_height_{};
+		int scale_thread_count_ = 1;
+
+		bool stop_requested_{};
+		bool running_{};
+		bool eof_{};
+		//The worker stops when there is no seek to do
+		bool seek_only_{};
+		bool seeking_{};
+		std::optional<std::chrono::nanoseconds> seek_target_;
+
+		//Last timestamp requested by take_frame, used to know how far behind the worker is
+		std::optional<std::chrono::nanoseconds> target_timestamp_;
+		//Only used by the worker
+		AVDiscard skip_frame_ = AVDISCARD_DEFAULT;
+		bool skip_to_keyframe_{};
+		std::optional<frame_converter> converter_;
+		//Timestamp of the last frame that came out of the decoder, empty if the decoder was moved from the outside
+		std::optional<std::chrono::nanoseconds> decoder_timestamp_;
+
+		frame_pipeline_stats stats_;
+
+		void run();
+		//The mutex must be locked
+		void recycle(pipeline_frame&& frame);
+		//The mutex must be locked
+		void clear_queue();
+		//Converts the frame to the current output size
+		pipeline_frame make_entry(video_frame&& frame);
+		void seek_decoder(std::chrono::nanoseconds target_timestamp);
+		std::optional<video_frame> decode_next_frame();
+		void catch_up(std::chrono::nanoseconds frame_timestamp, std::chrono::nanoseconds frame_duration, std::chrono::nanoseconds target_timestamp);
+	};
+}
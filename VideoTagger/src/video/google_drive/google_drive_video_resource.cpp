@@ -80,25 +80,27 @@ namespace vt
 		return file_id_;
 	}
 
-	video_stream google_drive_video_resource::video() const
+	video_stream google_drive_video_resource::open_video() const
 	{
 		video_stream result;
 		if (!result.open_file(file_path()))
 		{
 			debug::panic("Failed to open video from path {}", file_path());
 		}
+		result.set_frame_index(get_frame_index());
+		if (has_proxy())
+		{
+			result.set_proxy_file(proxy_path());
+		}
 
 		return result;
 	}
 
-	std::function<bool()> google_drive_video_resource::update_thumbnail_task()
+	thumbnail_task google_drive_video_resource::update_thumbnail_task()
 	{
-		return []()
-		{
-			//TODO: implement
-			debug::error("Google drive thumbnail download is not yet implemented");
-			return false;
-		};
+		//TODO: implement
+		debug::error("Google drive thumbnail download is not yet implemented");
+		return {};
 	}
 
 	std::function<void()> google_drive_video_resource::on_refresh_task()
@@ -165,7 +167,7 @@ namespace vt
 
 		while (downloaded_size < file_size)
 		{
-			if (data->cancel)
+			if (data->token.is_cancelled())
 			{
 				return video_download_status::failure;
 			}
@@ -179,7 +181,7 @@ namespace vt
 				[&data, current_progress, file_size](uint64_t len, uint64_t total)
 				{
 					data->progress = current_progress + float(len) / file_size;
-					return !data->cancel;
+					return !data->token.is_cancelled();
 				}
 			);
 			if (get_result and (get_result->status == 200 or get_result->status == 206))
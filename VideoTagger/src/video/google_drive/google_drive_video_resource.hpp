@@ -11,14 +11,14 @@ namespace vt
 
 		const std::string& file_id() const;
 
-		video_stream video() const override;
-		std::function<bool()> update_thumbnail_task() override;
+		thumbnail_task update_thumbnail_task() override;
 		std::function<void()> on_refresh_task() override;
 		video_downloadable downloadable() const override;
 
 		void on_save(nlohmann::ordered_json& json) const override;
 	
 	protected:
+		video_stream open_video() const override;
 		video_download_status on_download(std::shared_ptr<video_download_data>) override;
 
 	private:
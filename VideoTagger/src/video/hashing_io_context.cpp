@@ -0,0 +1,168 @@
+#include "pch.hpp"
+#include "hashing_io_context.hpp"
+
+extern "C"
+{
+	#include <libavutil/error.h>
+	#include <libavutil/mem.h>
+}
+
+namespace vt
+{
+	hashing_io_context::~hashing_io_context()
+	{
+		close();
+	}
+
+	bool hashing_io_context::open(const std::filesystem::path& path)
+	{
+		close();
+
+		std::error_code ec;
+		file_size_ = static_cast<int64_t>(std::filesystem::file_size(path, ec));
+		if (ec)
+		{
+			return false;
+		}
+
+		file_.open(path, std::ios::binary);
+		if (!file_.is_open())
+		{
+			return false;
+		}
+
+		auto buffer = static_cast<uint8_t*>(av_malloc(buffer_size));
+		if (buffer == nullptr)
+		{
+			close();
+			return false;
+		}
+
+		io_context_ = avio_alloc_context(buffer, buffer_size, 0, this, &hashing_io_context::read_callback, nullptr, &hashing_io_context::seek_callback);
+		if (io_context_ == nullptr)
+		{
+			av_free(buffer);
+			close();
+			return false;
+		}
+
+		hash_ = utils::hash::sha256_stream();
+		position_ = 0;
+		hashed_size_ = 0;
+		bytes_read_ = 0;
+		return true;
+	}
+
+	void hashing_io_context::close()
+	{
+		if (io_context_ != nullptr)
+		{
+			// The buffer might have been reallocated by avio
+			av_freep(&io_context_->buffer);
+			avio_context_free(&io_context_);
+		}
+
+		file_.close();
+		file_.clear();
+	}
+
+	AVIOContext* hashing_io_context::context()
+	{
+		return io_context_;
+	}
+
+	std::vector<uint8_t> hashing_io_context::finish()
+	{
+		if (!file_.is_open())
+		{
+			return {};
+		}
+
+		std::vector<uint8_t> buffer(buffer_size);
+		if (seek(hashed_size_, SEEK_SET) < 0)
+		{
+			return {};
+		}
+
+		while (hashed_size_ < file_size_)
+		{
+			if (read(buffer.data(), buffer_size) <= 0)
+			{
+				return {};
+			}
+		}
+
+		return hash_.finish();
+	}
+
+	uint64_t hashing_io_context::bytes_read() const
+	{
+		return bytes_read_;
+	}
+
+	int hashing_io_context::read(uint8_t* buffer, int size)
+	{
+		file_.read(reinterpret_cast<char*>(buffer), size);
+		auto read_bytes = static_cast<int64_t>(file_.gcount());
+		if (read_bytes <= 0)
+		{
+			return AVERROR_EOF;
+		}
+
+		hash(buffer, position_, read_bytes);
+		position_ += read_bytes;
+		bytes_read_ += static_cast<uint64_t>(read_bytes);
+		return static_cast<int>(read_bytes);
+	}
+
+	int64_t hashing_io_context::seek(int64_t offset, int whence)
+	{
+		whence &= ~AVSEEK_FORCE;
+		if (whence == AVSEEK_SIZE)
+		{
+			return file_size_;
+		}
+
+		int64_t target{};
+		switch (whence)
+		{
+			case SEEK_SET: target = offset; break;
+			case SEEK_CUR: target = position_ + offset; break;
+			case SEEK_END: target = file_size_ + offset; break;
+			default: return AVERROR(EINVAL);
+		}
+
+		// Reading past the end sets the eof flag, which also blocks seeking
+		file_.clear();
+		if (target < 0 or !file_.seekg(target))
+		{
+			return AVERROR(EIO);
+		}
+
+		position_ = target;
+		return target;
+	}
+
+	void hashing_io_context::hash(const uint8_t* data, int64_t position, int64_t size)
+	{
+		// Bytes before the hashed part were already hashed, bytes after a gap have to wait for finish
+		if (position > hashed_size_ or position + size <= hashed_size_)
+		{
+			return;
+		}
+
+		auto offset = hashed_size_ - position;
+		hash_.update(data + offset, static_cast<size_t>(size - offset));
+		hashed_size_ = position + size;
+	}
+
+	int hashing_io_context::read_callback(void* opaque, uint8_t* buffer, int size)
+	{
+		return static_cast<hashing_io_context*>(opaque)->read(buffer, size);
+	}
+
+	int64_t hashing_io_context::seek_callback(void* opaque, int64_t offset, int whence)
+	{
+		return static_cast<hashing_io_context*>(opaque)->seek(offset, whence);
+	}
+}
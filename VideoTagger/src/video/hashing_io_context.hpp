@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include <utils/hash.hpp>
+
+extern "C"
+{
+	#include <libavformat/avio.h>
+}
+
+namespace vt
+{
+	//Reads a file for the demuxer and hashes the bytes on the way, so importing a video reads it only once
+	//Only bytes that continue the hashed part are hashed, finish reads whatever the demuxer skipped
+	class hashing_io_context
+	{
+	public:
+		static constexpr int buffer_size = 256 * 1024;
+
+		hashing_io_context() = default;
+		hashing_io_context(const hashing_io_context&) = delete;
+		hashing_io_context(hashing_io_context&&) = delete;
+		~hashing_io_context();
+
+		hashing_io_context& operator=(const hashing_io_context&) = delete;
+		hashing_io_context& operator=(hashing_io_context&&) = delete;
+
+		bool open(const std::filesystem::path& path);
+		void close();
+
+		//Passed to the decoder, it stays owned by this object
+		[[nodiscard]] AVIOContext* context();
+		//Hashes the rest of the file and returns the sha256 of all of it, empty on error
+		[[nodiscard]] std::vector<uint8_t> finish();
+
+		//Every byte read from the disk, including the ones that were read more than once
+		[[nodiscard]] uint64_t bytes_read() const;
+
+	private:
+		std::ifstream file_;
+		AVIOContext* io_context_{};
+		utils::hash::sha256_stream hash_;
+		int64_t file_size_{};
+		int64_t position_{};
+		int64_t hashed_size_{};
+		uint64_t bytes_read_{};
+
+		int read(uint8_t* buffer, int size);
+		int64_t seek(int64_t offset, int whence);
+		void hash(const uint8_t* data, int64_t position, int64_t size);
+
+		static int read_callback(void* opaque, uint8_t* buffer, int size);
+		static int64_t seek_callback(void* opaque, int64_t offset, int whence);
+	};
+}
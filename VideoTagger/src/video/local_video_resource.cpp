@@ -4,15 +4,24 @@
 #include <video/video_stream.hpp>
 #include <utils/filesystem.hpp>
 #include <core/debug.hpp>
+#include <core/app_context.hpp>
 
 namespace vt
 {
-	
+	static make_metadata_include_fields import_metadata_fields()
+	{
+		// The full hash is computed later by project::schedule_hash_video, the fingerprint is used to find possible duplicates
+		make_metadata_include_fields fields;
+		fields.sha256 = false;
+		return fields;
+	}
 
 	local_video_resource::local_video_resource(video_id_t id, std::filesystem::path path) :
-		video_resource(local_video_importer::static_importer_id, id, make_video_metadata_from_path(path))
+		video_resource(local_video_importer::static_importer_id, id, make_video_metadata_from_path(path, import_metadata_fields()))
 	{
 		set_file_path(std::filesystem::relative(path).u8string());
+		// Computed here so it's done on the import thread
+		(void)fingerprint();
 	}
 
 	local_video_resource::local_video_resource(const nlohmann::ordered_json& json) :
@@ -23,33 +32,32 @@ namespace vt
 		return std::filesystem::is_regular_file(file_path());
 	}
 
-	video_stream local_video_resource::video() const
+	video_stream local_video_resource::open_video() const
 	{
 		video_stream result;
 		if (!result.open_file(file_path()))
 		{
 			debug::panic("Failed to open video from path {}", file_path());
 		}
+		result.set_frame_index(get_frame_index());
+		if (has_proxy())
+		{
+			result.set_proxy_file(proxy_path());
+		}
 
 		return result;
 	}
 
-	std::function<bool()> local_video_resource::update_thumbnail_task()
+	thumbnail_task local_video_resource::update_thumbnail_task()
 	{
-		return [this]()
+		return [path = std::filesystem::path(file_path()), cache_path = thumbnail_cache_path()]()
 		{
-			video_stream video;
-			if (!video.open_file(file_path()))
+			auto result = decode_thumbnail(path);
+			if (result.has_value() and !cache_path.empty() and !save_thumbnail(*result, cache_path))
 			{
-				debug::error("Failed to open video from path {}", file_path());
-				return false;
+				debug::warn("Failed to save thumbnail to {}", cache_path.u8string());
 			}
-
-			gl_texture result(video.width() / 2, video.height() / 2, GL_RGB);
-			video.get_thumbnail(result);
-			set_thumbnail(std::move(result));
-
-			return true;
+			return result;
 		};
 	}
 }
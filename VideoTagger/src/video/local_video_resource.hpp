@@ -13,7 +13,9 @@ namespace vt
 		local_video_resource(const nlohmann::ordered_json& json);
 
 		bool playable() const override;
-		video_stream video() const override;
-		std::function<bool()> update_thumbnail_task() override;
+		thumbnail_task update_thumbnail_task() override;
+
+	protected:
+		video_stream open_video() const override;
 	};
 }
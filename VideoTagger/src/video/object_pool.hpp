@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace vt
+{
+	struct object_pool_stats
+	{
+		//Objects that had to be allocated because the pool was empty
+		uint64_t allocations{};
+		uint64_t reuses{};
+		size_t available{};
+	};
+
+	//Recycles packet and frame wrappers, object_t must have reset() which releases the data but keeps the wrapped object allocated
+	template<typename object_t>
+	class object_pool
+	{
+	public:
+		static constexpr size_t default_max_size = 64;
+
+		explicit object_pool(size_t max_size = default_max_size) : max_size_{ max_size }
+		{
+			objects_.reserve(max_size_);
+		}
+
+		object_pool(const object_pool&) = delete;
+		object_pool(object_pool&&) = delete;
+
+		object_pool& operator=(const object_pool&) = delete;
+		object_pool& operator=(object_pool&&) = delete;
+
+		[[nodiscard]] object_t acquire()
+		{
+			{
+				std::unique_lock lock(mutex_);
+				if (!objects_.empty())
+				{
+					object_t result = std::move(objects_.back());
+					objects_.pop_back();
+					++stats_.reuses;
+					return result;
+				}
+				++stats_.allocations;
+			}
+
+			return object_t();
+		}
+
+		void release(object_t&& object)
+		{
+			if (object.unwrapped() == nullptr)
+			{
+				return;
+			}
+
+			object.reset();
+
+			std::unique_lock lock(mutex_);
+			if (objects_.size() < max_size_)
+			{
+				objects_.push_back(std::move(object));
+			}
+		}
+
+		[[nodiscard]] object_pool_stats stats() const
+		{
+			std::unique_lock lock(mutex_);
+			auto result = stats_;
+			result.available = objects_.size();
+			return result;
+		}
+
+	private:
+		mutable std::mutex mutex_;
+		std::vector<object_t> objects_;
+		size_t max_size_;
+		object_pool_stats stats_;
+	};
+}
@@ -0,0 +1,191 @@
+#include "pch.hpp"
+#include "thumbnail_atlas.hpp"
+
+namespace vt
+{
+	thumbnail_atlas::thumbnail_atlas(size_t budget_bytes) : budget_{ budget_bytes }
+	{
+	}
+
+	void thumbnail_atlas::set_budget(size_t budget_bytes)
+	{
+		budget_ = budget_bytes;
+	}
+
+	std::optional<thumbnail_tile> thumbnail_atlas::find(video_id_t video_id)
+	{
+		auto it = tile_map_.find(video_id);
+		if (it == tile_map_.end())
+		{
+			return std::nullopt;
+		}
+
+		tiles_.splice(tiles_.begin(), tiles_, it->second);
+		auto& entry = *it->second;
+		entry.last_frame = frame_;
+		return make_tile(entry);
+	}
+
+	bool thumbnail_atlas::contains(video_id_t video_id) const
+	{
+		return tile_map_.find(video_id) != tile_map_.end();
+	}
+
+	thumbnail_tile thumbnail_atlas::insert(video_id_t video_id, const thumbnail_image& image)
+	{
+		erase(video_id);
+
+		tile_entry entry;
+		entry.video_id = video_id;
+		entry.width = std::min(image.width, slot_size);
+		entry.height = std::min(image.height, slot_size);
+		entry.last_frame = frame_;
+		entry.slot = acquire_slot();
+
+		int slot_index = entry.slot % slots_per_page;
+		auto& page = pages_[entry.slot / slots_per_page];
+		page.set_pixels(slot_index % slots_per_row * slot_size, slot_index / slots_per_row * slot_size, entry.width, entry.height, image.pixels.data(), image.row_length);
+		++uploads_;
+
+		tiles_.push_front(entry);
+		tile_map_[video_id] = tiles_.begin();
+		return make_tile(entry);
+	}
+
+	void thumbnail_atlas::erase(video_id_t video_id)
+	{
+		auto it = tile_map_.find(video_id);
+		if (it == tile_map_.end())
+		{
+			return;
+		}
+
+		free_slots_.insert(it->second->slot);
+		tiles_.erase(it->second);
+		tile_map_.erase(it);
+	}
+
+	void thumbnail_atlas::clear()
+	{
+		pages_.clear();
+		free_slots_.clear();
+		tiles_.clear();
+		tile_map_.clear();
+	}
+
+	void thumbnail_atlas::next_frame()
+	{
+		++frame_;
+
+		// Only the last page can be released, it's kept while any of its tiles were drawn in the previous frame
+		while (pages_.size() > max_pages())
+		{
+			int first_slot = static_cast<int>(pages_.size() - 1) * slots_per_page;
+			bool drawn = std::any_of(tiles_.begin(), tiles_.end(), [this, first_slot](const tile_entry& entry)
+			{
+				return entry.slot >= first_slot and entry.last_frame + 1 >= frame_;
+			});
+			if (drawn)
+			{
+				break;
+			}
+
+			for (auto it = tiles_.begin(); it != tiles_.end();)
+			{
+				auto next = std::next(it);
+				if (it->slot >= first_slot)
+				{
+					evict(it);
+				}
+				it = next;
+			}
+
+			free_slots_.erase(free_slots_.lower_bound(first_slot), free_slots_.end());
+			pages_.pop_back();
+		}
+	}
+
+	thumbnail_atlas_stats thumbnail_atlas::stats() const
+	{
+		thumbnail_atlas_stats result;
+		result.resident_bytes = pages_.size() * page_bytes;
+		result.budget_bytes = budget_;
+		result.page_count = pages_.size();
+		result.tile_count = tiles_.size();
+		result.slot_count = pages_.size() * slots_per_page;
+		result.uploads = uploads_;
+		result.evictions = evictions_;
+
+		if (!tiles_.empty())
+		{
+			size_t covered_pixels{};
+			for (const auto& entry : tiles_)
+			{
+				covered_pixels += static_cast<size_t>(entry.width) * entry.height;
+			}
+			result.fill_ratio = static_cast<float>(covered_pixels) / (tiles_.size() * slot_size * slot_size);
+		}
+		return result;
+	}
+
+	size_t thumbnail_atlas::capacity() const
+	{
+		return max_pages() * slots_per_page;
+	}
+
+	size_t thumbnail_atlas::max_pages() const
+	{
+		return std::max<size_t>(budget_ / page_bytes, 1);
+	}
+
+	int thumbnail_atlas::acquire_slot()
+	{
+		if (free_slots_.empty())
+		{
+			if (pages_.size() < max_pages() or tiles_.empty() or tiles_.back().last_frame == frame_)
+			{
+				add_page();
+			}
+			else
+			{
+				evict(std::prev(tiles_.end()));
+			}
+		}
+
+		int result = *free_slots_.begin();
+		free_slots_.erase(free_slots_.begin());
+		return result;
+	}
+
+	void thumbnail_atlas::add_page()
+	{
+		int first_slot = static_cast<int>(pages_.size()) * slots_per_page;
+		pages_.emplace_back(page_size, page_size, GL_RGB);
+		for (int i = 0; i < slots_per_page; i++)
+		{
+			free_slots_.insert(first_slot + i);
+		}
+	}
+
+	void thumbnail_atlas::evict(tile_list::iterator it)
+	{
+		free_slots_.insert(it->slot);
+		tile_map_.erase(it->video_id);
+		tiles_.erase(it);
+		++evictions_;
+	}
+
+	thumbnail_tile thumbnail_atlas::make_tile(const tile_entry& entry) const
+	{
+		int slot_index = entry.slot % slots_per_page;
+		float x = static_cast<float>(slot_index % slots_per_row * slot_size);
+		float y = static_cast<float>(slot_index / slots_per_row * slot_size);
+
+		// Half a texel is left out on every side, so linear filtering doesn't pick up the neighbouring slots
+		thumbnail_tile result;
+		result.texture = pages_[entry.slot / slots_per_page].id();
+		result.uv0 = ImVec2{ (x + 0.5f) / page_size, (y + 0.5f) / page_size };
+		result.uv1 = ImVec2{ (x + entry.width - 0.5f) / page_size, (y + entry.height - 0.5f) / page_size };
+		return result;
+	}
+}
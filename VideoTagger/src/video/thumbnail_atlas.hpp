@@ -0,0 +1,105 @@
+#pragma once
+#include <cstdint>
+#include <list>
+#include <optional>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include <imgui.h>
+#include <core/gl_texture.hpp>
+#include <core/types.hpp>
+
+#include "video_thumbnail.hpp"
+
+namespace vt
+{
+	struct thumbnail_tile
+	{
+		GLuint texture{};
+		ImVec2 uv0;
+		ImVec2 uv1;
+	};
+
+	struct thumbnail_atlas_stats
+	{
+		size_t resident_bytes{};
+		size_t budget_bytes{};
+		size_t page_count{};
+		size_t tile_count{};
+		size_t slot_count{};
+		//Part of the pixels of the used slots that is covered by thumbnails
+		float fill_ratio{};
+		uint64_t uploads{};
+		uint64_t evictions{};
+	};
+
+	//Packs the thumbnails of videos into shared textures (pages), each divided into a grid of slots
+	//When a new page would exceed the budget, the least recently used thumbnail that wasn't drawn in the current frame is evicted,
+	//the owner reloads it when it's needed again
+	//Only thumbnails drawn in the current frame can push it over the budget, such pages are released by next_frame once they are no longer drawn
+	//Must be used on the render thread
+	class thumbnail_atlas
+	{
+	public:
+		static constexpr int slot_size = thumbnail_max_size;
+		static constexpr int page_size = 2048;
+		static constexpr int slots_per_row = page_size / slot_size;
+		static constexpr int slots_per_page = slots_per_row * slots_per_row;
+		static constexpr size_t page_bytes = size_t{ page_size } * page_size * 3;
+
+		explicit thumbnail_atlas(size_t budget_bytes = 0);
+		thumbnail_atlas(const thumbnail_atlas&) = delete;
+		thumbnail_atlas(thumbnail_atlas&&) = default;
+
+		thumbnail_atlas& operator=(const thumbnail_atlas&) = delete;
+		thumbnail_atlas& operator=(thumbnail_atlas&&) = default;
+
+		//At least one page is always allowed
+		void set_budget(size_t budget_bytes);
+		//Number of thumbnails that fit in the budget
+		[[nodiscard]] size_t capacity() const;
+
+		//Returns the tile and marks it as drawn in the current frame, nullopt if the thumbnail isn't resident
+		[[nodiscard]] std::optional<thumbnail_tile> find(video_id_t video_id);
+		[[nodiscard]] bool contains(video_id_t video_id) const;
+		//Uploads the thumbnail, replacing the old one if the video already has a tile, images bigger than a slot are cropped
+		thumbnail_tile insert(video_id_t video_id, const thumbnail_image& image);
+		void erase(video_id_t video_id);
+		void clear();
+
+		//Called once per frame, releases the pages above the budget that aren't drawn anymore
+		void next_frame();
+
+		[[nodiscard]] thumbnail_atlas_stats stats() const;
+
+	private:
+		struct tile_entry
+		{
+			video_id_t video_id{};
+			int slot{};
+			int width{};
+			int height{};
+			uint64_t last_frame{};
+		};
+
+		using tile_list = std::list<tile_entry>;
+
+		std::vector<gl_texture> pages_;
+		//Lower slots are used first, so the last pages empty out and can be released
+		std::set<int> free_slots_;
+		//Most recently used first
+		tile_list tiles_;
+		std::unordered_map<video_id_t, tile_list::iterator> tile_map_;
+		size_t budget_;
+		uint64_t frame_{};
+
+		uint64_t uploads_{};
+		uint64_t evictions_{};
+
+		[[nodiscard]] size_t max_pages() const;
+		int acquire_slot();
+		void add_page();
+		void evict(tile_list::iterator it);
+		[[nodiscard]] thumbnail_tile make_tile(const tile_entry& entry) const;
+	};
+}
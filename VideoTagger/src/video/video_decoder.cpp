@@ -1,5 +1,6 @@
 #include "pch.hpp"
 #include "video_decoder.hpp"
+#include <core/debug.hpp>
 
 extern "C"
 {
@@ -79,6 +80,27 @@ namespace vt
 		return *this;
 	}
 
+	video_frame video_frame::make_reference() const
+	{
+		video_frame result;
+		make_reference(result);
+		return result;
+	}
+
+	void video_frame::make_reference(video_frame& target) const
+	{
+		av_frame_unref(target.frame_);
+		if (av_frame_ref(target.frame_, frame_) < 0)
+		{
+			throw std::bad_alloc();
+		}
+	}
+
+	void video_frame::reset()
+	{
+		av_frame_unref(frame_);
+	}
+
 	video_plane video_frame::get_plane(size_t plane_index) const
 	{
 		return video_plane(frame_->data[plane_index], int64_t(frame_->linesize[plane_index]) * frame_->height, frame_->linesize[plane_index]);
@@ -129,30 +151,6 @@ namespace vt
 		return frame_->flags & AV_FRAME_FLAG_KEY;
 	}
 
-	std::optional<typename stream_type_traits<stream_type::video>::decoded_packet_type> stream_type_traits<stream_type::video>::decode(AVCodecContext* codec_context, class packet_wrapper& packet)
-	{
-		AVPacket* unwrapped_packet = packet.unwrapped();
-
-		if (avcodec_send_packet(codec_context, unwrapped_packet) != 0)
-		{
-			//TODO: some better error handling
-			return std::nullopt;
-		}
-
-		std::optional<video_frame> frame = video_frame();
-		AVFrame* unwrapped_frame = frame.value().unwrapped();
-
-		if (avcodec_receive_frame(codec_context, unwrapped_frame) != 0)
-		{
-			//TODO: some better error handling
-			return std::nullopt;
-		}
-
-		unwrapped_frame->time_base = unwrapped_packet->time_base;
-
-		return frame;
-	}
-
 	packet_wrapper::packet_wrapper() : packet_{ av_packet_alloc() }, type_{ stream_type::unknown }
 	{
 		if (packet_ == nullptr)
@@ -200,6 +198,12 @@ namespace vt
 		type_ = type;
 	}
 
+	void packet_wrapper::reset()
+	{
+		av_packet_unref(packet_);
+		type_ = stream_type::unknown;
+	}
+
 	int packet_wrapper::stream_index() const
 	{
 		return packet_->stream_index;
@@ -230,7 +234,7 @@ namespace vt
 		return packet_->flags & AV_PKT_FLAG_KEY;
 	}
 
-	packet_queue::packet_queue() : stream_index_{ -1 } {}
+	packet_queue::packet_queue() : stream_index_{ -1 }, packets_(initial_capacity) {}
 
 	bool packet_queue::push_front(packet_wrapper&& packet)
 	{
@@ -316,6 +320,11 @@ namespace vt
 		return packets_.size();
 	}
 
+	size_t packet_queue::capacity() const
+	{
+		return packets_.capacity();
+	}
+
 	int packet_queue::stream_index() const
 	{
 		return stream_index_;
@@ -383,16 +392,49 @@ namespace vt
 		return *this;
 	}
 
+	decode_mode decode_mode::full()
+	{
+		return decode_mode{};
+	}
+
+	decode_mode decode_mode::preview()
+	{
+		decode_mode result;
+		result.lowres = 1;
+		result.skip_loop_filter = true;
+		result.keyframes_only = true;
+		return result;
+	}
+
+	bool decode_mode::is_full() const
+	{
+		return *this == full();
+	}
+
+	bool decode_mode::operator==(const decode_mode& other) const
+	{
+		return lowres == other.lowres and skip_loop_filter == other.skip_loop_filter and keyframes_only == other.keyframes_only;
+	}
+
+	bool decode_mode::operator!=(const decode_mode& other) const
+	{
+		return !(*this == other);
+	}
+
 	video_decoder::video_decoder() :
-		format_context_{ nullptr }, stream_indices_{}, codec_contexts_{}, packet_queues_{},
-		last_read_packet_type_{ stream_type::unknown }, eof_{ false }, pixel_format_{} //, current_frame_number_{ 0 }
+		format_context_{ nullptr }, pixel_format_{}, stream_indices_{}, codec_contexts_{}, packet_queues_{},
+		packet_pool_{ std::make_unique<object_pool<packet_wrapper>>() }, frame_pool_{ std::make_unique<object_pool<video_frame>>() },
+		last_read_packet_type_{ stream_type::unknown }, eof_{ false } //, current_frame_number_{ 0 }
 	{
 		std::fill(stream_indices_.begin(), stream_indices_.end(), -1);
 	}
 
 	video_decoder::video_decoder(video_decoder&& other) noexcept :
-		format_context_{ other.format_context_ }, stream_indices_(other.stream_indices_), codec_contexts_(other.codec_contexts_),
-		packet_queues_(std::move(other.packet_queues_)), last_read_packet_type_{ other.last_read_packet_type_ }, eof_{ other.eof_ }, pixel_format_{}
+		format_context_{ other.format_context_ }, pixel_format_{}, stream_indices_(other.stream_indices_), codec_contexts_(other.codec_contexts_),
+		packet_queues_(std::move(other.packet_queues_)), frame_index_{ std::move(other.frame_index_) }, thread_count_{ other.thread_count_ },
+		decode_mode_{ other.decode_mode_ }, skip_frame_{ other.skip_frame_ },
+		packet_pool_{ std::move(other.packet_pool_) }, frame_pool_{ std::move(other.frame_pool_) }, last_read_packet_type_{ other.last_read_packet_type_ }, eof_{ other.eof_ },
+		draining_{ other.draining_ }, drained_{ other.drained_ }
 	{
 		for (auto& codec_context : other.codec_contexts_)
 		{
@@ -413,8 +455,16 @@ namespace vt
 		stream_indices_ = other.stream_indices_;
 		codec_contexts_ = other.codec_contexts_;
 		packet_queues_ = std::move(other.packet_queues_);
+		frame_index_ = std::move(other.frame_index_);
+		thread_count_ = other.thread_count_;
+		decode_mode_ = other.decode_mode_;
+		skip_frame_ = other.skip_frame_;
+		packet_pool_ = std::move(other.packet_pool_);
+		frame_pool_ = std::move(other.frame_pool_);
 		last_read_packet_type_ = other.last_read_packet_type_;
 		eof_ = other.eof_;
+		draining_ = other.draining_;
+		drained_ = other.drained_;
 
 		for (auto& codec_context : other.codec_contexts_)
 		{
@@ -425,7 +475,7 @@ namespace vt
 		return *this;
 	}
 
-	bool video_decoder::open(const std::filesystem::path& path)
+	bool video_decoder::open(const std::filesystem::path& path, bool probe_only, AVIOContext* io_context)
 	{
 		if (is_open())
 		{
@@ -433,14 +483,68 @@ namespace vt
 		}
 
 		format_context_ = avformat_alloc_context();
+		if (io_context != nullptr)
+		{
+			format_context_->pb = io_context;
+			format_context_->flags |= AVFMT_FLAG_CUSTOM_IO;
+		}
+		if (probe_only)
+		{
+			// Only used if the headers don't have everything, metadata doesn't need precise stream info
+			format_context_->probesize = probe_size;
+			format_context_->max_analyze_duration = probe_analyze_duration;
+		}
+
 		if (avformat_open_input(&format_context_, path.u8string().c_str(), NULL, NULL) < 0)
 		{
 			return false;
 		}
 
-		std::array<AVCodecParameters*, static_cast<size_t>(stream_type::size)> codec_params_array{};
 		std::array<const AVCodec*, static_cast<size_t>(stream_type::size)> codecs_array{};
 
+		if (probe_only)
+		{
+			// Containers like mpeg-ts only find their streams by reading packets
+			if (!find_streams(codecs_array) or !has_header_stream_info())
+			{
+				avformat_find_stream_info(format_context_, NULL);
+				if (!find_streams(codecs_array))
+				{
+					close();
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		if (!find_streams(codecs_array))
+		{
+			close();
+			return false;
+		}
+
+		for (size_t i = 0; i < static_cast<size_t>(stream_type::size); i++)
+		{
+			if (stream_indices_[i] < 0)
+			{
+				continue;
+			}
+
+			if (!open_codec_context(static_cast<stream_type>(i), codecs_array[i]))
+			{
+				close();
+				return false;
+			}
+		}
+
+		avformat_find_stream_info(format_context_, NULL);
+
+		return true;
+	}
+
+	bool video_decoder::find_streams(std::array<const AVCodec*, static_cast<size_t>(stream_type::size)>& codecs_array)
+	{
 		bool found_any_stream = false;
 
 		// No idea if one file can have multiple streams of the same type
@@ -463,49 +567,64 @@ namespace vt
 
 			stream_indices_.at(static_cast<size_t>(type)) = static_cast<int>(i);
 
-			codec_params_array.at(static_cast<size_t>(type)) = codec_params;
 			codecs_array.at(static_cast<size_t>(type)) = codec;
 			found_any_stream = true;
 
 		}
 
-		if (!found_any_stream)
+		return found_any_stream;
+	}
+
+	bool video_decoder::has_header_stream_info() const
+	{
+		if (!has_stream(stream_type::video) or format_context_->duration == AV_NOPTS_VALUE)
 		{
-			close();
 			return false;
 		}
 
-		for (size_t i = 0; i < static_cast<size_t>(stream_type::size); i++)
-		{
-			if (stream_indices_[i] < 0)
-			{
-				continue;
-			}
+		auto video_stream = format_context_->streams[stream_indices_[static_cast<size_t>(stream_type::video)]];
+		bool has_frame_rate = video_stream->avg_frame_rate.num > 0 or video_stream->r_frame_rate.num > 0;
+		return video_stream->codecpar->width > 0 and video_stream->codecpar->height > 0 and has_frame_rate;
+	}
 
-			codec_contexts_[i] = avcodec_alloc_context3(codecs_array[i]);
-			if (codec_contexts_[i] == nullptr)
-			{
-				// Highly unlikely, basically critical failure
+	bool video_decoder::open_codec_context(stream_type type, const AVCodec* codec)
+	{
+		auto& codec_context = codec_contexts_.at(static_cast<size_t>(type));
+		if (codec_context != nullptr)
+		{
+			avcodec_free_context(&codec_context);
+		}
 
-				close();
-				return false;
-			}
+		codec_context = avcodec_alloc_context3(codec);
+		if (codec_context == nullptr)
+		{
+			// Highly unlikely, basically critical failure
+			return false;
+		}
 
-			if (avcodec_parameters_to_context(codec_contexts_[i], codec_params_array[i]) < 0)
-			{
-				close();
-				return false;
-			}
+		auto codec_params = format_context_->streams[stream_indices_.at(static_cast<size_t>(type))]->codecpar;
+		if (avcodec_parameters_to_context(codec_context, codec_params) < 0)
+		{
+			return false;
+		}
 
-			if (avcodec_open2(codec_contexts_[i], codecs_array[i], NULL) < 0)
-			{
-				close();
-				return false;
-			}
+		if (type == stream_type::video)
+		{
+			// Has to be set before the codec is opened, unsupported threading types are ignored by the codec
+			codec_context->thread_count = thread_count_;
+			codec_context->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+			codec_context->lowres = std::clamp(decode_mode_.lowres, 0, static_cast<int>(codec->max_lowres));
 		}
 
-		avformat_find_stream_info(format_context_, NULL);
+		if (avcodec_open2(codec_context, codec, NULL) < 0)
+		{
+			return false;
+		}
 
+		if (type == stream_type::video)
+		{
+			apply_skip_settings();
+		}
 		return true;
 	}
 
@@ -516,10 +635,7 @@ namespace vt
 			stream_index = -1;
 		}
 
-		for (auto& queue : packet_queues_)
-		{
-			queue.clear();
-		}
+		discard_all_packets();
 
 		for (auto& codec_context : codec_contexts_)
 		{
@@ -529,19 +645,19 @@ namespace vt
 			}
 		}
 
-		if (format_context_ != nullptr)
-		{
-			avformat_free_context(format_context_);
-			format_context_ = nullptr;
-		}
+		// Also closes the file, avformat_free_context would leak it
+		avformat_close_input(&format_context_);
 
+		frame_index_.reset();
 		eof_ = false;
+		draining_ = false;
+		drained_ = false;
 		last_read_packet_type_ = stream_type::unknown;
 	}
 
 	void video_decoder::read_packet()
 	{
-		packet_wrapper packet;
+		packet_wrapper packet = acquire_packet();
 		AVPacket* unwrapped_packet = packet.unwrapped();
 
 		int read_frame_result;
@@ -552,6 +668,7 @@ namespace vt
 			if (read_frame_result == AVERROR_EOF)
 			{
 				eof_ = true;
+				recycle_packet(std::move(packet));
 				return;
 			}
 			else if (read_frame_result == AVERROR_INVALIDDATA)
@@ -564,13 +681,17 @@ namespace vt
 			}
 			else if (read_frame_result != 0)
 			{
-				//TODO: Do something
+				// The rest of the file can't be read, treat it as the end so that the codecs get drained
+				debug::warn("Failed to read a packet, error code: {}", read_frame_result);
+				eof_ = true;
+				recycle_packet(std::move(packet));
 				return;
 			}
 
 			auto it = std::find(stream_indices_.begin(), stream_indices_.end(), packet.stream_index());
 			if (it == stream_indices_.end())
 			{
+				av_packet_unref(unwrapped_packet);
 				continue;
 			}
 
@@ -603,6 +724,11 @@ namespace vt
 		return eof_;
 	}
 
+	bool video_decoder::drained() const
+	{
+		return drained_;
+	}
+
 	bool video_decoder::has_stream(stream_type type) const
 	{
 		return stream_indices_.at(static_cast<size_t>(type)) >= 0;
@@ -648,62 +774,115 @@ namespace vt
 
 	void video_decoder::discard_next_packet(stream_type type)
 	{
-		packet_queues_[static_cast<size_t>(type)].pop_front();
+		auto& queue = packet_queues_[static_cast<size_t>(type)];
+		if (queue.empty())
+		{
+			return;
+		}
+
+		recycle_packet(std::move(queue.front()));
+		queue.pop_front();
 	}
 
 	void video_decoder::discard_last_read_packet()
 	{
-		packet_queues_[static_cast<size_t>(last_read_packet_type())].pop_back();
+		auto& queue = packet_queues_[static_cast<size_t>(last_read_packet_type())];
+		if (queue.empty())
+		{
+			return;
+		}
+
+		recycle_packet(std::move(queue.back()));
+		queue.pop_back();
 	}
 
 	void video_decoder::discard_all_packets()
 	{
-		for (auto& queue : packet_queues_)
+		for (size_t i = 0; i < packet_queues_.size(); i++)
 		{
-			queue.clear();
+			discard_all_packets(static_cast<stream_type>(i));
 		}
 	}
 
 	void video_decoder::discard_all_packets(stream_type type)
 	{
-		packet_queues_[static_cast<size_t>(type)].clear();
+		auto& queue = packet_queues_[static_cast<size_t>(type)];
+		while (!queue.empty())
+		{
+			recycle_packet(std::move(queue.front()));
+			queue.pop_front();
+		}
 	}
 
-	void video_decoder::seek_keyframe(std::chrono::nanoseconds timestamp)
+	bool video_decoder::seek_keyframe(std::chrono::nanoseconds timestamp)
 	{
-		//TODO https://github.com/bmewj/video-app/blob/master/src/video_reader.cpp write this like here
-
 		//TODO: handle invalid timestamp
 
+		if (frame_index_ != nullptr)
+		{
+			return seek_keyframe(frame_index_->frame_number(timestamp));
+		}
+
+		return seek_timestamp(timestamp);
+	}
+
+	bool video_decoder::seek_keyframe(size_t frame_number)
+	{
+		if (frame_index_ == nullptr)
+		{
+			return seek_timestamp(frame_number_to_timestamp(frame_number));
+		}
+
 		auto video_stream_index = stream_indices_[static_cast<size_t>(stream_type::video)];
-		
-		auto timestamp_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(timestamp);
-		int64_t seek_timestamp = static_cast<int64_t>(timestamp_seconds.count() / av_q2d(format_context_->streams[video_stream_index]->time_base));
+		const auto& keyframe = frame_index_->at(frame_index_->keyframe_before(std::min(frame_number, frame_index_->size() - 1)));
 
 		eof_ = false;
-		if (av_seek_frame(format_context_, video_stream_index, seek_timestamp, AVSEEK_FLAG_BACKWARD) < 0)
+
+		// Timestamps in streams with discontinuities can't be trusted, the byte position of the keyframe is exact
+		bool seek_by_position = (format_context_->iformat->flags & AVFMT_TS_DISCONT) and keyframe.position >= 0;
+		int seek_result = seek_by_position ?
+			av_seek_frame(format_context_, video_stream_index, keyframe.position, AVSEEK_FLAG_BYTE) :
+			av_seek_frame(format_context_, video_stream_index, keyframe.pts, AVSEEK_FLAG_BACKWARD);
+
+		if (seek_result < 0)
 		{
-			// TODO: Handle error
-			return;
+			// The index can be stale or the demuxer may not support byte seeking, let the demuxer find the keyframe instead
+			debug::warn("Failed to seek to indexed keyframe of frame {}, error code: {}", frame_number, seek_result);
+			return seek_timestamp(frame_number_to_timestamp(frame_number));
 		}
 		discard_all_packets();
+		flush_codecs();
+		return true;
 	}
 
-	void video_decoder::seek_keyframe(size_t frame_number)
+	bool video_decoder::seek_timestamp(std::chrono::nanoseconds timestamp)
 	{
-		auto video_stream = format_context_->streams[stream_indices_[static_cast<size_t>(stream_type::video)]];
-		
-		seek_keyframe(std::chrono::nanoseconds(static_cast<int64_t>(frame_number / fps() * 1'000'000'000)));
+		auto video_stream_index = stream_indices_[static_cast<size_t>(stream_type::video)];
+
+		auto timestamp_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(timestamp);
+		int64_t stream_timestamp = static_cast<int64_t>(timestamp_seconds.count() / av_q2d(format_context_->streams[video_stream_index]->time_base));
+
+		eof_ = false;
+		int seek_result = av_seek_frame(format_context_, video_stream_index, stream_timestamp, AVSEEK_FLAG_BACKWARD);
+		if (seek_result < 0)
+		{
+			debug::warn("Failed to seek to {}ns, error code: {}", timestamp.count(), seek_result);
+			return false;
+		}
+		discard_all_packets();
+		flush_codecs();
+		return true;
 	}
 
 	int video_decoder::width() const
 	{
-		return codec_contexts_[static_cast<size_t>(stream_type::video)]->width;
+		// The codec context size is reduced by lowres
+		return format_context_->streams[stream_indices_[static_cast<size_t>(stream_type::video)]]->codecpar->width;
 	}
 
 	int video_decoder::height() const
 	{
-		return codec_contexts_[static_cast<size_t>(stream_type::video)]->height;
+		return format_context_->streams[stream_indices_[static_cast<size_t>(stream_type::video)]]->codecpar->height;
 	}
 
 	double video_decoder::fps() const
@@ -741,6 +920,11 @@ namespace vt
 	{
 		auto video_stream = format_context_->streams[stream_indices_[static_cast<size_t>(stream_type::video)]];
 
+		if (frame_index_ != nullptr)
+		{
+			return frame_index_->size();
+		}
+
 		size_t frame_count = video_stream->nb_frames;
 
 		double duration_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(duration()).count();
@@ -760,15 +944,301 @@ namespace vt
 
 	std::chrono::nanoseconds video_decoder::frame_number_to_timestamp(size_t frame) const
 	{
+		if (frame_index_ != nullptr)
+		{
+			return frame_index_->timestamp(frame);
+		}
+
 		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(frame / fps()));
 	}
 	
 	size_t video_decoder::timestamp_to_frame_number(std::chrono::nanoseconds timestamp) const
 	{
+		if (frame_index_ != nullptr)
+		{
+			return frame_index_->frame_number(timestamp);
+		}
+
 		//TODO: test
 		return static_cast<size_t>(std::round(std::chrono::duration_cast<std::chrono::duration<double>>(timestamp).count() * fps()));
 	}
 
+	void video_decoder::set_skip_frame(AVDiscard value)
+	{
+		skip_frame_ = value;
+		apply_skip_settings();
+	}
+
+	bool video_decoder::set_decode_mode(const decode_mode& mode)
+	{
+		if (mode == decode_mode_)
+		{
+			return true;
+		}
+
+		bool reopen = mode.lowres != decode_mode_.lowres;
+		decode_mode_ = mode;
+
+		auto video_codec_context = codec_contexts_[static_cast<size_t>(stream_type::video)];
+		if (video_codec_context == nullptr)
+		{
+			return true;
+		}
+
+		if (reopen and std::clamp(mode.lowres, 0, static_cast<int>(video_codec_context->codec->max_lowres)) != video_codec_context->lowres)
+		{
+			if (!open_codec_context(stream_type::video, video_codec_context->codec))
+			{
+				debug::error("Failed to reopen the video codec with lowres {}", mode.lowres);
+				return false;
+			}
+
+			discard_all_packets(stream_type::video);
+			return true;
+		}
+
+		apply_skip_settings();
+		return true;
+	}
+
+	const decode_mode& video_decoder::get_decode_mode() const
+	{
+		return decode_mode_;
+	}
+
+	void video_decoder::apply_skip_settings()
+	{
+		auto video_codec_context = codec_contexts_[static_cast<size_t>(stream_type::video)];
+		if (video_codec_context == nullptr)
+		{
+			return;
+		}
+
+		video_codec_context->skip_frame = decode_mode_.keyframes_only ? std::max(skip_frame_, AVDISCARD_NONKEY) : skip_frame_;
+		video_codec_context->skip_loop_filter = decode_mode_.skip_loop_filter ? AVDISCARD_ALL : AVDISCARD_DEFAULT;
+	}
+
+	bool video_decoder::set_thread_count(int count)
+	{
+		count = std::max(count, 1);
+		if (count == thread_count_)
+		{
+			return true;
+		}
+
+		thread_count_ = count;
+		if (!has_stream(stream_type::video))
+		{
+			return true;
+		}
+
+		auto video_codec_context = codec_contexts_[static_cast<size_t>(stream_type::video)];
+		if (video_codec_context == nullptr or video_codec_context->thread_count == count)
+		{
+			return true;
+		}
+
+		if (!open_codec_context(stream_type::video, video_codec_context->codec))
+		{
+			debug::error("Failed to reopen the video codec with {} threads", count);
+			return false;
+		}
+
+		discard_all_packets(stream_type::video);
+		return true;
+	}
+
+	int video_decoder::thread_count() const
+	{
+		return thread_count_;
+	}
+
+	void video_decoder::set_frame_index(std::shared_ptr<const frame_index> index)
+	{
+		if (index != nullptr and (index->empty() or index->stream_index() != stream_indices_[static_cast<size_t>(stream_type::video)]))
+		{
+			index.reset();
+		}
+
+		frame_index_ = std::move(index);
+	}
+
+	const frame_index* video_decoder::get_frame_index() const
+	{
+		return frame_index_.get();
+	}
+
+	void video_decoder::flush_codecs()
+	{
+		for (auto codec_context : codec_contexts_)
+		{
+			if (codec_context != nullptr)
+			{
+				avcodec_flush_buffers(codec_context);
+			}
+		}
+
+		draining_ = false;
+		drained_ = false;
+	}
+
+	bool video_decoder::send_next_packet()
+	{
+		auto codec_context = codec_contexts_[static_cast<size_t>(stream_type::video)];
+		if (codec_context == nullptr or draining_)
+		{
+			return false;
+		}
+
+		auto& queue = packet_queues_[static_cast<size_t>(stream_type::video)];
+		if (queue.empty())
+		{
+			if (!eof_)
+			{
+				return false;
+			}
+
+			avcodec_send_packet(codec_context, nullptr);
+			draining_ = true;
+			return true;
+		}
+
+		int result = avcodec_send_packet(codec_context, queue.front().unwrapped());
+		if (result == AVERROR(EAGAIN))
+		{
+			return false;
+		}
+
+		if (result < 0)
+		{
+			// The packet is skipped, the codec can still decode the following ones
+			debug::warn("Failed to send a packet to the codec, error code: {}", result);
+		}
+
+		recycle_packet(std::move(queue.front()));
+		queue.pop_front();
+		return true;
+	}
+
+	std::optional<video_frame> video_decoder::receive_frame()
+	{
+		auto codec_context = codec_contexts_[static_cast<size_t>(stream_type::video)];
+		if (codec_context == nullptr or drained_)
+		{
+			return std::nullopt;
+		}
+
+		auto frame = acquire_frame();
+		AVFrame* unwrapped_frame = frame.unwrapped();
+
+		int result = avcodec_receive_frame(codec_context, unwrapped_frame);
+		if (result != 0)
+		{
+			if (result == AVERROR_EOF)
+			{
+				drained_ = true;
+			}
+
+			recycle_frame(std::move(frame));
+			return std::nullopt;
+		}
+
+		if (unwrapped_frame->pts == AV_NOPTS_VALUE)
+		{
+			unwrapped_frame->pts = unwrapped_frame->best_effort_timestamp;
+		}
+		unwrapped_frame->time_base = format_context_->streams[stream_indices_[static_cast<size_t>(stream_type::video)]]->time_base;
+
+		return frame;
+	}
+
+	std::optional<video_frame> video_decoder::decode_next_frame()
+	{
+		while (!drained_)
+		{
+			auto frame = receive_frame();
+			if (frame.has_value())
+			{
+				return frame;
+			}
+
+			if (packet_queue_size(stream_type::video) == 0 and !eof_)
+			{
+				read_packet();
+				if (!eof_ and last_read_packet_type() != stream_type::video)
+				{
+					discard_last_read_packet();
+					continue;
+				}
+			}
+
+			send_next_packet();
+		}
+
+		return std::nullopt;
+	}
+
+	video_frame video_decoder::acquire_frame()
+	{
+		if (frame_pool_ == nullptr)
+		{
+			return video_frame();
+		}
+
+		return frame_pool_->acquire();
+	}
+
+	void video_decoder::recycle_frame(video_frame&& frame)
+	{
+		if (frame_pool_ != nullptr)
+		{
+			frame_pool_->release(std::move(frame));
+		}
+	}
+
+	object_pool<video_frame>* video_decoder::frame_pool()
+	{
+		return frame_pool_.get();
+	}
+
+	object_pool_stats video_decoder::packet_pool_stats() const
+	{
+		return packet_pool_ != nullptr ? packet_pool_->stats() : object_pool_stats{};
+	}
+
+	object_pool_stats video_decoder::frame_pool_stats() const
+	{
+		return frame_pool_ != nullptr ? frame_pool_->stats() : object_pool_stats{};
+	}
+
+	size_t video_decoder::packet_queue_capacity() const
+	{
+		size_t result{};
+		for (const auto& queue : packet_queues_)
+		{
+			result += queue.capacity();
+		}
+		return result;
+	}
+
+	packet_wrapper video_decoder::acquire_packet()
+	{
+		if (packet_pool_ == nullptr)
+		{
+			return packet_wrapper();
+		}
+
+		return packet_pool_->acquire();
+	}
+
+	void video_decoder::recycle_packet(packet_wrapper&& packet)
+	{
+		if (packet_pool_ != nullptr)
+		{
+			packet_pool_->release(std::move(packet));
+		}
+	}
+
 	packet_queue& video_decoder::get_packet_queue(stream_type type)
 	{
 		return packet_queues_.at(static_cast<size_t>(type));
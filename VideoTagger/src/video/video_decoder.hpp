@@ -5,12 +5,16 @@
 #include <deque>
 #include <optional>
 #include <chrono>
+#include <memory>
+#include <utils/ring_buffer.hpp>
 
 extern "C"
 {
 	#include <libavcodec/avcodec.h>
 	#include <libavformat/avformat.h>
 }
+#include "frame_index.hpp"
+#include "object_pool.hpp"
 
 namespace vt
 {
@@ -43,6 +47,13 @@ namespace vt
 		video_frame& operator=(const video_frame&) = delete;
 		video_frame& operator=(video_frame&& rhs) noexcept;
 
+		//Returns a frame that shares the pixel buffers with this one
+		[[nodiscard]] video_frame make_reference() const;
+		//Same as make_reference, but reuses the target frame
+		void make_reference(video_frame& target) const;
+		//Releases the pixel buffers, the frame can be reused after that
+		void reset();
+
 		[[nodiscard]] video_plane get_plane(size_t plane_index) const;
 
 		[[nodiscard]] int width() const;
@@ -80,16 +91,12 @@ namespace vt
 	struct stream_type_traits
 	{
 		using decoded_packet_type = void;
-
-		static std::optional<decoded_packet_type> decode(AVCodecContext* codec_context, class packet_wrapper& packet);
 	};
 
 	template<>
 	struct stream_type_traits<stream_type::video>
 	{
 		using decoded_packet_type = video_frame;
-
-		static std::optional<decoded_packet_type> decode(AVCodecContext* codec_context, class packet_wrapper& packet);
 	};
 
 	class packet_wrapper
@@ -104,6 +111,8 @@ namespace vt
 		packet_wrapper& operator=(packet_wrapper&& rhs) noexcept;
 
 		void set_type(stream_type type);
+		//Releases the packet data, the packet can be reused after that
+		void reset();
 		
 		[[nodiscard]] stream_type type() const;
 		[[nodiscard]] int stream_index() const;
@@ -125,7 +134,9 @@ namespace vt
 	class packet_queue
 	{
 	public:
-		using container = std::deque<packet_wrapper>;
+		static constexpr size_t initial_capacity = 64;
+
+		using container = ring_buffer<packet_wrapper>;
 		using iterator = container::iterator;
 		using const_iterator = container::const_iterator;
 
@@ -152,6 +163,8 @@ namespace vt
 		[[nodiscard]] const packet_wrapper& at(size_t index) const;
 
 		[[nodiscard]] size_t size() const;
+		//Grows when a packet is pushed onto a full queue and never shrinks
+		[[nodiscard]] size_t capacity() const;
 		[[nodiscard]] int stream_index() const;
 		[[nodiscard]] bool empty() const;
 
@@ -184,9 +197,32 @@ namespace vt
 		std::chrono::nanoseconds duration;
 	};
 
+	//Trades image quality for decoding speed, meant for thumbnails and scrubbing
+	struct decode_mode
+	{
+		//Each step halves the decoded resolution, it's limited to what the codec supports (most modern codecs don't)
+		int lowres{};
+		bool skip_loop_filter{};
+		bool keyframes_only{};
+
+		//Full quality decoding
+		static decode_mode full();
+		//Cheapest decoding that still looks good enough in a preview
+		static decode_mode preview();
+
+		[[nodiscard]] bool is_full() const;
+
+		bool operator==(const decode_mode& other) const;
+		bool operator!=(const decode_mode& other) const;
+	};
+
 	class video_decoder
 	{
 	public:
+		//Limits for reading packets in probe only mode when the headers are incomplete
+		static constexpr int64_t probe_size = 1024 * 1024;
+		static constexpr int64_t probe_analyze_duration = AV_TIME_BASE;
+
 		video_decoder();
 		video_decoder(const video_decoder&) = delete;
 		video_decoder(video_decoder&& other) noexcept;
@@ -195,29 +231,40 @@ namespace vt
 		video_decoder& operator=(const video_decoder&) = delete;
 		video_decoder& operator=(video_decoder&& other) noexcept;
 
-		bool open(const std::filesystem::path& path);
+		//With probe_only the codecs aren't opened and stream info is read from the container headers when they have it
+		//That's enough for the metadata, but the decoder can't decode anything
+		//If io_context isn't null the file is read through it, it has to outlive the decoder and isn't freed by it
+		bool open(const std::filesystem::path& path, bool probe_only = false, AVIOContext* io_context = nullptr);
 		void close();
 
 		//TODO: Maybe should return the read packet
 		// Will read the file until it encounters a packet that it can save to one of the packet queues or reaches eof.
 		void read_packet();
 
-		template<stream_type type>
-		[[nodiscard]] std::optional<typename stream_type_traits<type>::decoded_packet_type> decode_next_packet();
+		//Sends the next queued video packet to the codec. When the queue is empty and the file reached eof the codec is put into draining mode.
+		//Returns false if nothing was sent, the codec might need its frames to be received first
+		bool send_next_packet();
+		//Returns the next frame produced by the codec, nullopt if the codec needs more packets or has been drained
+		[[nodiscard]] std::optional<video_frame> receive_frame();
+		//Decodes until a frame is produced, reads packets from the file when needed and discards packets of other streams
+		//Returns nullopt when all frames were decoded
+		[[nodiscard]] std::optional<video_frame> decode_next_frame();
 		void discard_next_packet(stream_type type);
 		void discard_last_read_packet();
 		void discard_all_packets();
 		void discard_all_packets(stream_type type);
 
 		//Seek to the nearest keyframe before or on the timestamp
-		//Discards all packets currently in queues
-		void seek_keyframe(std::chrono::nanoseconds timestamp);
-		//Seek to the nearest keyframe before or on the timestamp
-		//Discards all packets currently in queues
-		void seek_keyframe(size_t frame_number);
+		//Discards all packets currently in queues, returns false if the seek failed and the position didn't change
+		bool seek_keyframe(std::chrono::nanoseconds timestamp);
+		//Seek to the nearest keyframe before or on the frame
+		//Falls back to seeking by timestamp if the indexed keyframe can't be reached, returns false if both fail
+		bool seek_keyframe(size_t frame_number);
 
 		[[nodiscard]] bool is_open() const;
 		[[nodiscard]] bool eof() const;
+		//True when the file reached eof and all buffered frames were received from the codec
+		[[nodiscard]] bool drained() const;
 		[[nodiscard]] bool has_stream(stream_type type) const;
 		[[nodiscard]] stream_type last_read_packet_type() const;
 
@@ -239,6 +286,22 @@ namespace vt
 		[[nodiscard]] std::chrono::nanoseconds frame_number_to_timestamp(size_t frame) const;
 		[[nodiscard]] size_t timestamp_to_frame_number(std::chrono::nanoseconds timestamp) const;
 
+		//Frames of the given type will be skipped by the video codec, the decode mode can skip more
+		void set_skip_frame(AVDiscard value);
+		//Reopens the video codec if the lowres factor changes, the decoder has to be moved to a keyframe after that
+		bool set_decode_mode(const decode_mode& mode);
+		[[nodiscard]] const decode_mode& get_decode_mode() const;
+		//Drops the frames buffered in the codecs
+		void flush_codecs();
+
+		//Reopens the video codec if it's already open, the decoder has to be moved to a keyframe after that
+		bool set_thread_count(int count);
+		[[nodiscard]] int thread_count() const;
+
+		//The index must have been built from the same file, it's ignored if it was built for a different stream
+		void set_frame_index(std::shared_ptr<const frame_index> index);
+		[[nodiscard]] const frame_index* get_frame_index() const;
+
 		[[nodiscard]] packet_queue& get_packet_queue(stream_type type);
 		[[nodiscard]] const packet_queue& get_packet_queue(stream_type type) const;
 
@@ -246,6 +309,16 @@ namespace vt
 
 		[[nodiscard]] AVFormatContext* av_format_context();
 
+		//Frames are recycled to avoid allocating a new AVFrame for every decoded frame
+		[[nodiscard]] video_frame acquire_frame();
+		void recycle_frame(video_frame&& frame);
+		[[nodiscard]] object_pool<video_frame>* frame_pool();
+
+		[[nodiscard]] object_pool_stats packet_pool_stats() const;
+		[[nodiscard]] object_pool_stats frame_pool_stats() const;
+		//Slots allocated by the packet queues of all streams
+		[[nodiscard]] size_t packet_queue_capacity() const;
+
 	private:
 		AVFormatContext* format_context_;
 		AVPixelFormat pixel_format_;
@@ -254,31 +327,30 @@ namespace vt
 		std::array<AVCodecContext*, static_cast<size_t>(stream_type::size)> codec_contexts_;
 		std::array<packet_queue, static_cast<size_t>(stream_type::size)> packet_queues_;
 
+		std::shared_ptr<const frame_index> frame_index_;
+		int thread_count_ = 1;
+		decode_mode decode_mode_;
+		AVDiscard skip_frame_ = AVDISCARD_DEFAULT;
+
+		// Pointers so they stay in place when the decoder is moved
+		std::unique_ptr<object_pool<packet_wrapper>> packet_pool_;
+		std::unique_ptr<object_pool<video_frame>> frame_pool_;
+
 		stream_type last_read_packet_type_;
 		bool eof_;
+		bool draining_{};
+		bool drained_{};
 
 		//size_t current_frame_number_;
-	};
 
-	template<stream_type type>
-	inline std::optional<typename stream_type_traits<type>::decoded_packet_type> video_decoder::decode_next_packet()
-	{
-		if (!has_stream(type))
-		{
-			return std::nullopt;
-		}
-
-		auto& queue = packet_queues_[static_cast<size_t>(type)];
-		if (queue.empty())
-		{
-			return std::nullopt;
-		}
-
-		packet_wrapper packet;
-		queue >> packet;
-
-		AVCodecContext* codec_context = codec_contexts_[static_cast<size_t>(type)];
-
-		return stream_type_traits<type>::decode(codec_context, packet);
-	}
+		bool open_codec_context(stream_type type, const AVCodec* codec);
+		//Picks the streams and their decoders, returns false if there's no stream that can be decoded
+		bool find_streams(std::array<const AVCodec*, static_cast<size_t>(stream_type::size)>& codecs_array);
+		[[nodiscard]] bool has_header_stream_info() const;
+		void apply_skip_settings();
+		//Seeks the demuxer without the frame index
+		bool seek_timestamp(std::chrono::nanoseconds timestamp);
+		[[nodiscard]] packet_wrapper acquire_packet();
+		void recycle_packet(packet_wrapper&& packet);
+	};
 }
@@ -0,0 +1,304 @@
+#include "pch.hpp"
+#include "video_filmstrip.hpp"
+#include "video_decoder.hpp"
+#include "frame_converter.hpp"
+#include <core/app_context.hpp>
+#include <core/debug.hpp>
+
+namespace vt
+{
+	static constexpr std::array<char, 4> filmstrip_magic = { 'V', 'T', 'F', 'S' };
+
+	video_filmstrip::video_filmstrip(const std::filesystem::path& video_path, const std::filesystem::path& cache_path, std::chrono::nanoseconds duration, const filmstrip_settings& settings) :
+		state_{ std::make_shared<shared_state>() }, duration_{ duration }
+	{
+		job_ = ctx_.jobs.submit(utils::job_priority::background, [state = state_, video_path, cache_path, duration, settings]()
+		{
+			build(state, video_path, cache_path, duration, settings);
+		}, state_->token);
+	}
+
+	video_filmstrip::~video_filmstrip()
+	{
+		// The job keeps the state alive, so it doesn't have to be waited for
+		state_->token.cancel();
+	}
+
+	void video_filmstrip::update_texture()
+	{
+		if (done_)
+		{
+			return;
+		}
+
+		std::unique_lock lock(state_->mutex);
+		if (state_->generation == uploaded_generation_)
+		{
+			return;
+		}
+
+		auto& image = state_->sheet.image;
+		if (!texture_.has_value() or texture_->width() != image.width or texture_->height() != image.height)
+		{
+			texture_.emplace(image.width, image.height, GL_RGB);
+		}
+		texture_->set_pixels(image.pixels.data(), image.row_length);
+
+		uploaded_sheet_.frame_width = state_->sheet.frame_width;
+		uploaded_sheet_.frame_height = state_->sheet.frame_height;
+		uploaded_sheet_.columns = state_->sheet.columns;
+		uploaded_sheet_.decoded = state_->sheet.decoded;
+		uploaded_sheet_.image.width = image.width;
+		uploaded_sheet_.image.height = image.height;
+		uploaded_generation_ = state_->generation;
+
+		// Nothing changes anymore, the pixels only live in the texture from now on
+		if (state_->done)
+		{
+			done_ = true;
+			image.pixels = {};
+		}
+	}
+
+	std::optional<filmstrip_frame> video_filmstrip::find_frame(std::chrono::nanoseconds timestamp) const
+	{
+		const auto& decoded = uploaded_sheet_.decoded;
+		if (!texture_.has_value() or decoded.empty() or duration_.count() <= 0)
+		{
+			return std::nullopt;
+		}
+
+		int frame_count = static_cast<int>(decoded.size());
+		int index = std::clamp(static_cast<int>(timestamp.count() * frame_count / duration_.count()), 0, frame_count - 1);
+
+		// Until the sheet is refined the nearest decoded frame is used
+		std::optional<int> found;
+		for (int distance = 0; distance < frame_count and !found.has_value(); distance++)
+		{
+			if (index - distance >= 0 and decoded[index - distance])
+			{
+				found = index - distance;
+			}
+			else if (index + distance < frame_count and decoded[index + distance])
+			{
+				found = index + distance;
+			}
+		}
+
+		if (!found.has_value())
+		{
+			return std::nullopt;
+		}
+
+		float sheet_width = static_cast<float>(uploaded_sheet_.image.width);
+		float sheet_height = static_cast<float>(uploaded_sheet_.image.height);
+		float x = static_cast<float>(*found % uploaded_sheet_.columns * uploaded_sheet_.frame_width);
+		float y = static_cast<float>(*found / uploaded_sheet_.columns * uploaded_sheet_.frame_height);
+
+		filmstrip_frame result;
+		result.texture = texture_->id();
+		result.size = ImVec2{ static_cast<float>(uploaded_sheet_.frame_width), static_cast<float>(uploaded_sheet_.frame_height) };
+		result.uv0 = ImVec2{ x / sheet_width, y / sheet_height };
+		result.uv1 = ImVec2{ (x + result.size.x) / sheet_width, (y + result.size.y) / sheet_height };
+		return result;
+	}
+
+	bool video_filmstrip::is_done() const
+	{
+		return done_;
+	}
+
+	std::chrono::nanoseconds video_filmstrip::duration() const
+	{
+		return duration_;
+	}
+
+	void video_filmstrip::build(std::shared_ptr<shared_state> state, std::filesystem::path video_path, std::filesystem::path cache_path, std::chrono::nanoseconds duration, filmstrip_settings settings)
+	{
+		sheet_data sheet;
+		if (!cache_path.empty() and load(sheet, cache_path))
+		{
+			std::unique_lock lock(state->mutex);
+			state->sheet = std::move(sheet);
+			state->done = true;
+			++state->generation;
+			return;
+		}
+
+		video_decoder decoder;
+		decoder.set_thread_count(1);
+		if (!decoder.open(video_path) or !decoder.has_stream(stream_type::video) or decoder.width() <= 0 or decoder.height() <= 0 or duration.count() <= 0)
+		{
+			debug::warn("Failed to build the filmstrip of {}", video_path.u8string());
+			return;
+		}
+
+		int frame_count = std::max(settings.frame_count, 1);
+		sheet.frame_height = settings.frame_height;
+		sheet.frame_width = std::clamp(settings.frame_height * decoder.width() / decoder.height(), 1, settings.max_frame_width);
+		sheet.columns = std::min(settings.columns, frame_count);
+		sheet.decoded.assign(frame_count, false);
+
+		int rows = (frame_count + sheet.columns - 1) / sheet.columns;
+		auto& image = sheet.image;
+		image.width = sheet.columns * sheet.frame_width;
+		image.height = rows * sheet.frame_height;
+		image.row_length = image.width;
+		image.pixels.assign(static_cast<size_t>(image.width) * image.height * 3, 0);
+
+		decoder.set_decode_mode(thumbnail_decode_mode(decoder.width(), decoder.height(), sheet.frame_width, sheet.frame_height));
+
+		std::optional<frame_converter> converter;
+		std::vector<uint8_t> frame_pixels;
+
+		// Every pass halves the step, so the whole video is covered early and the gaps are filled in later
+		for (int step = std::min(coarse_step, frame_count); step >= 1; step /= 2)
+		{
+			for (int i = 0; i < frame_count; i += step)
+			{
+				if (state->token.is_cancelled())
+				{
+					return;
+				}
+
+				if (sheet.decoded[i])
+				{
+					continue;
+				}
+
+				decoder.seek_keyframe(duration * (2 * i + 1) / (2 * frame_count));
+				auto frame = decoder.decode_next_frame();
+				if (!frame.has_value())
+				{
+					continue;
+				}
+
+				if (!converter.has_value() or converter->source_width() != frame->width() or converter->source_height() != frame->height() or converter->source_format() != frame->pixel_format())
+				{
+					converter.emplace(frame->width(), frame->height(), frame->pixel_format(), sheet.frame_width, sheet.frame_height, AV_PIX_FMT_RGB24);
+				}
+				converter->convert_frame(*frame, frame_pixels);
+				decoder.recycle_frame(std::move(*frame));
+
+				size_t row_size = static_cast<size_t>(sheet.frame_width) * 3;
+				size_t x = static_cast<size_t>(i % sheet.columns) * row_size;
+				size_t y = static_cast<size_t>(i / sheet.columns) * sheet.frame_height;
+				for (int row = 0; row < sheet.frame_height; row++)
+				{
+					auto source = frame_pixels.begin() + static_cast<size_t>(row) * converter->destination_stride();
+					std::copy_n(source, row_size, image.pixels.begin() + (y + row) * image.width * 3 + x);
+				}
+				sheet.decoded[i] = true;
+			}
+
+			std::unique_lock lock(state->mutex);
+			state->sheet = sheet;
+			state->done = step == 1;
+			++state->generation;
+		}
+
+		// Frames that failed to decode are tried again next time
+		bool complete = std::all_of(sheet.decoded.begin(), sheet.decoded.end(), [](bool decoded) { return decoded; });
+		if (complete and !cache_path.empty() and !save(sheet, cache_path))
+		{
+			debug::warn("Failed to save the filmstrip to {}", cache_path.u8string());
+		}
+	}
+
+	bool video_filmstrip::load(sheet_data& sheet, const std::filesystem::path& cache_path)
+	{
+		std::ifstream file(cache_path, std::ios::binary);
+		if (!file.is_open())
+		{
+			return false;
+		}
+
+		std::array<char, 4> magic{};
+		uint32_t version{};
+		int32_t frame_width{};
+		int32_t frame_height{};
+		int32_t columns{};
+		int32_t frame_count{};
+		uint64_t data_size{};
+
+		file.read(magic.data(), magic.size());
+		file.read(reinterpret_cast<char*>(&version), sizeof(version));
+		file.read(reinterpret_cast<char*>(&frame_width), sizeof(frame_width));
+		file.read(reinterpret_cast<char*>(&frame_height), sizeof(frame_height));
+		file.read(reinterpret_cast<char*>(&columns), sizeof(columns));
+		file.read(reinterpret_cast<char*>(&frame_count), sizeof(frame_count));
+		file.read(reinterpret_cast<char*>(&data_size), sizeof(data_size));
+
+		if (!file or magic != filmstrip_magic or version != file_version or frame_width <= 0 or frame_height <= 0 or columns <= 0 or frame_count <= 0)
+		{
+			return false;
+		}
+
+		// Checked before allocating, a corrupt size mustn't make it allocate more than the file holds
+		std::error_code error;
+		uint64_t file_size = std::filesystem::file_size(cache_path, error);
+		uint64_t header_size = static_cast<uint64_t>(file.tellg());
+		if (error or file_size < header_size or data_size > file_size - header_size)
+		{
+			return false;
+		}
+
+		std::vector<uint8_t> data(data_size);
+		file.read(reinterpret_cast<char*>(data.data()), data.size());
+		if (!file)
+		{
+			return false;
+		}
+
+		auto image = decode_thumbnail_data(data);
+		int64_t rows = (int64_t{ frame_count } + columns - 1) / columns;
+		if (!image.has_value() or image->width != int64_t{ columns } * frame_width or image->height != rows * frame_height)
+		{
+			return false;
+		}
+
+		sheet.image = std::move(*image);
+		sheet.frame_width = frame_width;
+		sheet.frame_height = frame_height;
+		sheet.columns = columns;
+		sheet.decoded.assign(frame_count, true);
+		return true;
+	}
+
+	bool video_filmstrip::save(const sheet_data& sheet, const std::filesystem::path& cache_path)
+	{
+		// The sheet is stored the same way as the thumbnails, as a single jpeg image
+		auto data = encode_thumbnail_data(sheet.image);
+		if (data.empty())
+		{
+			return false;
+		}
+
+		std::error_code error;
+		std::filesystem::create_directories(cache_path.parent_path(), error);
+
+		std::ofstream file(cache_path, std::ios::binary);
+		if (!file.is_open())
+		{
+			return false;
+		}
+
+		uint32_t version = file_version;
+		int32_t frame_width = sheet.frame_width;
+		int32_t frame_height = sheet.frame_height;
+		int32_t columns = sheet.columns;
+		int32_t frame_count = static_cast<int32_t>(sheet.decoded.size());
+		uint64_t data_size = data.size();
+
+		file.write(filmstrip_magic.data(), filmstrip_magic.size());
+		file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+		file.write(reinterpret_cast<const char*>(&frame_width), sizeof(frame_width));
+		file.write(reinterpret_cast<const char*>(&frame_height), sizeof(frame_height));
+		file.write(reinterpret_cast<const char*>(&columns), sizeof(columns));
+		file.write(reinterpret_cast<const char*>(&frame_count), sizeof(frame_count));
+		file.write(reinterpret_cast<const char*>(&data_size), sizeof(data_size));
+		file.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+		return static_cast<bool>(file);
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include <imgui.h>
+#include <core/gl_texture.hpp>
+#include <utils/job_scheduler.hpp>
+
+#include "video_thumbnail.hpp"
+
+namespace vt
+{
+	struct filmstrip_settings
+	{
+		int frame_count = 128;
+		int frame_height = 90;
+		//Frames wider than this are squeezed
+		int max_frame_width = 160;
+		int columns = 16;
+	};
+
+	struct filmstrip_frame
+	{
+		GLuint texture{};
+		ImVec2 uv0;
+		ImVec2 uv1;
+		//Size of the frame in the sheet in pixels
+		ImVec2 size;
+	};
+
+	//Evenly spaced low resolution frames of a video in a single sprite sheet
+	//The sheet is built on ctx_.jobs, first with every coarse_step-th frame and then refined until every frame is decoded
+	class video_filmstrip
+	{
+	public:
+		static constexpr uint32_t file_version = 1;
+		static constexpr const char* extension = "vtfs";
+		static constexpr int coarse_step = 8;
+
+		//Loads the sheet from cache_path if it exists, otherwise builds it and saves it there, an empty cache_path disables caching
+		video_filmstrip(const std::filesystem::path& video_path, const std::filesystem::path& cache_path, std::chrono::nanoseconds duration, const filmstrip_settings& settings = {});
+		video_filmstrip(const video_filmstrip&) = delete;
+		video_filmstrip(video_filmstrip&&) = delete;
+		//Cancels the build if it's still running
+		~video_filmstrip();
+
+		video_filmstrip& operator=(const video_filmstrip&) = delete;
+		video_filmstrip& operator=(video_filmstrip&&) = delete;
+
+		//Uploads the sheet if it was refined since the last call, must be called on the render thread
+		void update_texture();
+		//Returns the decoded frame nearest to the timestamp, nullopt if no frame is uploaded yet
+		[[nodiscard]] std::optional<filmstrip_frame> find_frame(std::chrono::nanoseconds timestamp) const;
+		[[nodiscard]] bool is_done() const;
+		[[nodiscard]] std::chrono::nanoseconds duration() const;
+
+	private:
+		struct sheet_data
+		{
+			thumbnail_image image;
+			int frame_width{};
+			int frame_height{};
+			int columns{};
+			std::vector<bool> decoded;
+		};
+
+		struct shared_state
+		{
+			std::mutex mutex;
+			sheet_data sheet;
+			uint64_t generation{};
+			bool done{};
+			//Also drops the job if it hasn't started yet
+			utils::cancellation_token token;
+		};
+
+		std::shared_ptr<shared_state> state_;
+		std::future<void> job_;
+		std::chrono::nanoseconds duration_{};
+
+		std::optional<gl_texture> texture_;
+		uint64_t uploaded_generation_{};
+		bool done_{};
+		//Layout of the uploaded sheet, the pixels aren't kept
+		sheet_data uploaded_sheet_;
+
+		static void build(std::shared_ptr<shared_state> state, std::filesystem::path video_path, std::filesystem::path cache_path, std::chrono::nanoseconds duration, filmstrip_settings settings);
+		static bool load(sheet_data& sheet, const std::filesystem::path& cache_path);
+		static bool save(const sheet_data& sheet, const std::filesystem::path& cache_path);
+	};
+}
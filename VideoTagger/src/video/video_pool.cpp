@@ -158,6 +158,19 @@ namespace vt
 		return true;
 	}
 
+	std::unique_ptr<video_resource> video_pool::extract(video_id_t video_id)
+	{
+		auto it = videos_.find(video_id);
+		if (it == videos_.end())
+		{
+			return nullptr;
+		}
+
+		auto result = std::move(it->second);
+		videos_.erase(it);
+		return result;
+	}
+
 	video_resource& video_pool::get(video_id_t video_id)
 	{
 		return const_cast<video_resource&>(std::as_const(*this).get(video_id));
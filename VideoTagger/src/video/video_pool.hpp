@@ -80,6 +80,8 @@ namespace vt
 
 		bool insert(std::unique_ptr<video_resource>&& vid_resource);
 		bool erase(video_id_t video_id);
+		//Removes the video from the pool without destroying it, returns nullptr if it isn't in the pool
+		std::unique_ptr<video_resource> extract(video_id_t video_id);
 
 		video_resource& get(video_id_t video_id);
 		const video_resource& get(video_id_t video_id) const;
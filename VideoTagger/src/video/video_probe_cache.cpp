@@ -0,0 +1,335 @@
+#include "pch.hpp"
+#include "video_probe_cache.hpp"
+#include "hashing_io_context.hpp"
+#include <utils/hash.hpp>
+#include <utils/json.hpp>
+#include <core/debug.hpp>
+
+#define NOMINMAX
+#ifndef WIN32_LEAN_AND_MEAN
+	#define WIN32_LEAN_AND_MEAN
+#endif
+#ifdef _WIN32
+	#include <Windows.h>
+#else
+	#include <sys/stat.h>
+#endif
+
+namespace vt
+{
+	static constexpr int probe_cache_version = 1;
+
+	//Inode on posix and file index on windows, 0 if it can't be read
+	static uint64_t get_file_id(const std::filesystem::path& path)
+	{
+#ifdef _WIN32
+		HANDLE file = CreateFileW(path.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return 0;
+		}
+
+		BY_HANDLE_FILE_INFORMATION info{};
+		bool success = GetFileInformationByHandle(file, &info);
+		CloseHandle(file);
+		return success ? (static_cast<uint64_t>(info.nFileIndexHigh) << 32) | info.nFileIndexLow : 0;
+#else
+		struct stat info{};
+		if (stat(path.c_str(), &info) != 0)
+		{
+			return 0;
+		}
+		return static_cast<uint64_t>(info.st_ino);
+#endif
+	}
+
+	std::optional<video_probe_cache::file_info> video_probe_cache::get_file_info(const std::filesystem::path& path)
+	{
+		std::error_code ec;
+		file_info result;
+		result.path = std::filesystem::absolute(path, ec).lexically_normal().u8string();
+		if (ec)
+		{
+			return std::nullopt;
+		}
+
+		result.size = std::filesystem::file_size(path, ec);
+		if (ec)
+		{
+			return std::nullopt;
+		}
+
+		result.write_time = std::filesystem::last_write_time(path, ec);
+		if (ec)
+		{
+			return std::nullopt;
+		}
+
+		result.id = get_file_id(path);
+		return result;
+	}
+
+	video_probe_cache::cache_entry* video_probe_cache::find_entry(const file_info& info)
+	{
+		auto it = entries_.find(info.path);
+		if (it == entries_.end())
+		{
+			return nullptr;
+		}
+
+		auto& entry = it->second;
+		if (entry.file_size != info.size or entry.write_time != info.write_time or entry.file_id != info.id)
+		{
+			return nullptr;
+		}
+
+		return &entry;
+	}
+
+	video_probe_cache::cache_entry& video_probe_cache::update_entry(const file_info& info)
+	{
+		auto* entry = find_entry(info);
+		if (entry != nullptr)
+		{
+			return *entry;
+		}
+
+		auto& result = entries_[info.path];
+		result = cache_entry{ info.size, info.write_time, info.id, std::nullopt, {} };
+		return result;
+	}
+
+	std::optional<video_metadata> video_probe_cache::probe(const std::filesystem::path& path, std::vector<uint8_t>* sha256)
+	{
+		auto info = get_file_info(path);
+
+		if (info.has_value())
+		{
+			std::unique_lock lock(mutex_);
+			auto* entry = find_entry(*info);
+			if (entry != nullptr and entry->metadata.has_value())
+			{
+				++hits_;
+				auto metadata = *entry->metadata;
+				lock.unlock();
+
+				if (sha256 != nullptr)
+				{
+					*sha256 = this->sha256(path);
+				}
+				return metadata;
+			}
+			++misses_;
+		}
+
+		// Probed without the lock, so imports on other threads don't wait for each other
+		hashing_io_context io_context;
+		if (sha256 != nullptr and !io_context.open(path))
+		{
+			return std::nullopt;
+		}
+
+		video_decoder decoder;
+		if (!decoder.open(path, true, io_context.context()) or !decoder.has_stream(stream_type::video))
+		{
+			return std::nullopt;
+		}
+
+		auto metadata = decoder.metadata();
+		decoder.close();
+
+		if (sha256 != nullptr)
+		{
+			*sha256 = io_context.finish();
+		}
+
+		if (info.has_value())
+		{
+			std::unique_lock lock(mutex_);
+			auto& entry = update_entry(*info);
+			entry.metadata = metadata;
+			if (sha256 != nullptr and !sha256->empty())
+			{
+				entry.sha256 = *sha256;
+			}
+			dirty_ = true;
+		}
+
+		return metadata;
+	}
+
+	std::vector<uint8_t> video_probe_cache::sha256(const std::filesystem::path& path, const utils::cancellation_token& token)
+	{
+		auto info = get_file_info(path);
+		if (info.has_value())
+		{
+			std::unique_lock lock(mutex_);
+			auto* entry = find_entry(*info);
+			if (entry != nullptr and !entry->sha256.empty())
+			{
+				++hash_hits_;
+				return entry->sha256;
+			}
+			++hash_misses_;
+		}
+
+		auto result = utils::hash::sha256_file(path, token);
+		if (info.has_value() and !result.empty())
+		{
+			std::unique_lock lock(mutex_);
+			update_entry(*info).sha256 = result;
+			dirty_ = true;
+		}
+
+		return result;
+	}
+
+	std::vector<uint8_t> video_probe_cache::cached_sha256(const std::filesystem::path& path)
+	{
+		auto info = get_file_info(path);
+		if (!info.has_value())
+		{
+			return {};
+		}
+
+		std::unique_lock lock(mutex_);
+		auto* entry = find_entry(*info);
+		if (entry == nullptr)
+		{
+			return {};
+		}
+
+		return entry->sha256;
+	}
+
+	void video_probe_cache::clear()
+	{
+		std::unique_lock lock(mutex_);
+		entries_.clear();
+		dirty_ = true;
+	}
+
+	bool video_probe_cache::load(const std::filesystem::path& filepath)
+	{
+		if (!std::filesystem::is_regular_file(filepath))
+		{
+			return false;
+		}
+
+		nlohmann::ordered_json json;
+		try
+		{
+			json = utils::json::load_from_file(filepath);
+		}
+		catch (const std::exception& ex)
+		{
+			debug::warn("Failed to load file cache: {}", ex.what());
+			return false;
+		}
+
+		if (!json.contains("version") or json["version"] != probe_cache_version or !json.contains("files"))
+		{
+			return false;
+		}
+
+		std::unique_lock lock(mutex_);
+		for (const auto& json_file : json["files"])
+		{
+			if (!json_file.contains("path") or !json_file.contains("size") or !json_file.contains("write-time"))
+			{
+				continue;
+			}
+
+			// A malformed entry is dropped instead of the whole cache
+			try
+			{
+				cache_entry entry;
+				entry.file_size = json_file["size"].get<uintmax_t>();
+				entry.write_time = std::filesystem::file_time_type{ std::filesystem::file_time_type::duration{ json_file["write-time"].get<std::filesystem::file_time_type::rep>() } };
+				entry.file_id = json_file.value("file-id", uint64_t{});
+				if (json_file.contains("sha256"))
+				{
+					entry.sha256 = utils::hash::hex_to_bytes(json_file["sha256"].get<std::string>());
+				}
+				if (json_file.contains("metadata"))
+				{
+					const auto& json_metadata = json_file["metadata"];
+					video_metadata metadata;
+					metadata.width = json_metadata.value("width", 0);
+					metadata.height = json_metadata.value("height", 0);
+					metadata.fps = json_metadata.value("fps", 0.0);
+					metadata.frame_count = json_metadata.value("frame-count", int64_t{});
+					metadata.duration = std::chrono::nanoseconds{ json_metadata.value("duration", std::chrono::nanoseconds::rep{}) };
+					entry.metadata = metadata;
+				}
+
+				entries_[json_file["path"].get<std::string>()] = std::move(entry);
+			}
+			catch (const std::exception& ex)
+			{
+				debug::warn("Skipping a file cache entry: {}", ex.what());
+			}
+		}
+		dirty_ = false;
+
+		return true;
+	}
+
+	bool video_probe_cache::save(const std::filesystem::path& filepath)
+	{
+		// Held until the file is written, so a save that finds nothing changed can't return before an earlier one is done
+		std::unique_lock save_lock(save_mutex_);
+		nlohmann::ordered_json json;
+		{
+			std::unique_lock lock(mutex_);
+			if (!dirty_)
+			{
+				return true;
+			}
+
+			json["version"] = probe_cache_version;
+			auto& json_files = json["files"];
+			json_files = nlohmann::ordered_json::array();
+			for (const auto& [path, entry] : entries_)
+			{
+				nlohmann::ordered_json json_file;
+				json_file["path"] = path;
+				json_file["size"] = entry.file_size;
+				json_file["write-time"] = entry.write_time.time_since_epoch().count();
+				json_file["file-id"] = entry.file_id;
+				if (!entry.sha256.empty())
+				{
+					json_file["sha256"] = utils::hash::bytes_to_hex(entry.sha256, utils::hash::string_case::lower);
+				}
+				if (entry.metadata.has_value())
+				{
+					auto& json_metadata = json_file["metadata"];
+					json_metadata["width"] = entry.metadata->width;
+					json_metadata["height"] = entry.metadata->height;
+					json_metadata["fps"] = entry.metadata->fps;
+					json_metadata["frame-count"] = entry.metadata->frame_count;
+					json_metadata["duration"] = entry.metadata->duration.count();
+				}
+				json_files.push_back(std::move(json_file));
+			}
+			dirty_ = false;
+		}
+
+		std::error_code ec;
+		std::filesystem::create_directories(filepath.parent_path(), ec);
+		return utils::json::write_to_file(json, filepath, true);
+	}
+
+	video_probe_cache_stats video_probe_cache::stats() const
+	{
+		std::unique_lock lock(mutex_);
+
+		video_probe_cache_stats result;
+		result.hits = hits_;
+		result.misses = misses_;
+		result.hash_hits = hash_hits_;
+		result.hash_misses = hash_misses_;
+		result.size = entries_.size();
+		return result;
+	}
+}
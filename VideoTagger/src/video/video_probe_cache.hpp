@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include <vector>
+
+#include "video_decoder.hpp"
+
+namespace vt
+{
+	struct video_probe_cache_stats
+	{
+		uint64_t hits{};
+		uint64_t misses{};
+		uint64_t hash_hits{};
+		uint64_t hash_misses{};
+		size_t size{};
+	};
+
+	//Metadata and hashes of files, shared by all projects and saved between runs
+	//An entry is only used while the size, the modification time and the file id (inode) of the file stay the same
+	//Can be used from multiple threads
+	class video_probe_cache
+	{
+	public:
+		video_probe_cache() = default;
+		video_probe_cache(const video_probe_cache&) = delete;
+		video_probe_cache(video_probe_cache&&) = delete;
+
+		video_probe_cache& operator=(const video_probe_cache&) = delete;
+		video_probe_cache& operator=(video_probe_cache&&) = delete;
+
+		//Opens the file without the codecs if it's not cached, returns nullopt if it has no video stream
+		//If sha256 isn't null it gets the hash of the file, which is computed from the same reads as the probe if it's not cached
+		[[nodiscard]] std::optional<video_metadata> probe(const std::filesystem::path& path, std::vector<uint8_t>* sha256 = nullptr);
+		//Hashes the file if it's not cached, returns an empty vector on error or if the token is cancelled while hashing
+		[[nodiscard]] std::vector<uint8_t> sha256(const std::filesystem::path& path, const utils::cancellation_token& token = {});
+		//Doesn't read the file, returns an empty vector if the hash isn't cached or the file changed
+		[[nodiscard]] std::vector<uint8_t> cached_sha256(const std::filesystem::path& path);
+		void clear();
+
+		//Entries that can't be read are skipped
+		bool load(const std::filesystem::path& filepath);
+		//Does nothing if nothing changed since the last load or save, saves from different threads are written one at a time
+		bool save(const std::filesystem::path& filepath);
+
+		[[nodiscard]] video_probe_cache_stats stats() const;
+
+	private:
+		struct file_info
+		{
+			std::string path;
+			uintmax_t size{};
+			std::filesystem::file_time_type write_time;
+			uint64_t id{};
+		};
+
+		struct cache_entry
+		{
+			uintmax_t file_size{};
+			std::filesystem::file_time_type write_time;
+			uint64_t file_id{};
+			std::optional<video_metadata> metadata;
+			std::vector<uint8_t> sha256;
+		};
+
+		mutable std::mutex mutex_;
+		std::mutex save_mutex_;
+		std::unordered_map<std::string, cache_entry> entries_;
+		bool dirty_{};
+
+		uint64_t hits_{};
+		uint64_t misses_{};
+		uint64_t hash_hits_{};
+		uint64_t hash_misses_{};
+
+		static std::optional<file_info> get_file_info(const std::filesystem::path& path);
+		//Returns nullptr if there is no entry for the file or it changed, the mutex must be locked
+		cache_entry* find_entry(const file_info& info);
+		//Returns the entry for the file, an outdated one is reset, the mutex must be locked
+		cache_entry& update_entry(const file_info& info);
+	};
+}
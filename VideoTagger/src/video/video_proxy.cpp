@@ -0,0 +1,227 @@
+#include "pch.hpp"
+#include "video_proxy.hpp"
+#include "video_decoder.hpp"
+#include <core/debug.hpp>
+
+extern "C"
+{
+	#include <libavcodec/avcodec.h>
+	#include <libavformat/avformat.h>
+	#include <libswscale/swscale.h>
+}
+
+namespace vt
+{
+	namespace
+	{
+		struct proxy_encoder
+		{
+			AVFormatContext* format_context{};
+			AVCodecContext* codec_context{};
+			AVStream* stream{};
+			SwsContext* sws_context{};
+			AVFrame* frame{};
+			AVPacket* packet{};
+			bool header_written{};
+
+			~proxy_encoder()
+			{
+				if (format_context != nullptr and format_context->pb != nullptr)
+				{
+					avio_closep(&format_context->pb);
+				}
+				avformat_free_context(format_context);
+				avcodec_free_context(&codec_context);
+				sws_freeContext(sws_context);
+				av_frame_free(&frame);
+				av_packet_free(&packet);
+			}
+
+			bool open(const std::filesystem::path& path, const AVFrame* source_frame, const video_proxy_settings& settings)
+			{
+				int height = std::min(settings.max_height, source_frame->height) & ~1;
+				int width = static_cast<int>(std::lround(static_cast<double>(source_frame->width) * height / source_frame->height)) & ~1;
+				if (width <= 0 or height <= 0)
+				{
+					return false;
+				}
+
+				auto codec = avcodec_find_encoder(AV_CODEC_ID_MJPEG);
+				if (codec == nullptr or avformat_alloc_output_context2(&format_context, nullptr, "matroska", nullptr) < 0)
+				{
+					return false;
+				}
+
+				codec_context = avcodec_alloc_context3(codec);
+				frame = av_frame_alloc();
+				packet = av_packet_alloc();
+				if (codec_context == nullptr or frame == nullptr or packet == nullptr)
+				{
+					return false;
+				}
+
+				codec_context->width = width;
+				codec_context->height = height;
+				codec_context->pix_fmt = AV_PIX_FMT_YUVJ420P;
+				codec_context->color_range = AVCOL_RANGE_JPEG;
+				// Same time base as the source, so the timestamps don't have to be converted
+				codec_context->time_base = source_frame->time_base;
+				codec_context->flags |= AV_CODEC_FLAG_QSCALE;
+				codec_context->global_quality = FF_QP2LAMBDA * std::clamp(settings.quality, 2, 31);
+				if (format_context->oformat->flags & AVFMT_GLOBALHEADER)
+				{
+					codec_context->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+				}
+
+				if (avcodec_open2(codec_context, codec, nullptr) < 0)
+				{
+					return false;
+				}
+
+				stream = avformat_new_stream(format_context, nullptr);
+				if (stream == nullptr or avcodec_parameters_from_context(stream->codecpar, codec_context) < 0)
+				{
+					return false;
+				}
+				stream->time_base = codec_context->time_base;
+
+				frame->width = width;
+				frame->height = height;
+				frame->format = codec_context->pix_fmt;
+				if (av_frame_get_buffer(frame, 0) < 0)
+				{
+					return false;
+				}
+
+				sws_context = sws_getContext(source_frame->width, source_frame->height, static_cast<AVPixelFormat>(source_frame->format), width, height, codec_context->pix_fmt, SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+				if (sws_context == nullptr)
+				{
+					return false;
+				}
+
+				if (avio_open(&format_context->pb, path.u8string().c_str(), AVIO_FLAG_WRITE) < 0 or avformat_write_header(format_context, nullptr) < 0)
+				{
+					return false;
+				}
+
+				header_written = true;
+				return true;
+			}
+
+			bool encode(const AVFrame* source_frame)
+			{
+				if (av_frame_make_writable(frame) < 0)
+				{
+					return false;
+				}
+
+				sws_scale(sws_context, source_frame->data, source_frame->linesize, 0, source_frame->height, frame->data, frame->linesize);
+				frame->pts = source_frame->pts;
+				frame->duration = source_frame->duration;
+
+				return avcodec_send_frame(codec_context, frame) >= 0 and write_packets();
+			}
+
+			bool finish()
+			{
+				return avcodec_send_frame(codec_context, nullptr) >= 0 and write_packets() and av_write_trailer(format_context) >= 0;
+			}
+
+			bool write_packets()
+			{
+				while (true)
+				{
+					int result = avcodec_receive_packet(codec_context, packet);
+					if (result == AVERROR(EAGAIN) or result == AVERROR_EOF)
+					{
+						return true;
+					}
+					if (result < 0)
+					{
+						return false;
+					}
+
+					av_packet_rescale_ts(packet, codec_context->time_base, stream->time_base);
+					packet->stream_index = stream->index;
+					if (av_interleaved_write_frame(format_context, packet) < 0)
+					{
+						return false;
+					}
+				}
+			}
+		};
+	}
+
+	bool video_proxy::generate(const std::filesystem::path& source, const std::filesystem::path& destination, const video_proxy_settings& settings, const std::function<bool(float)>& progress)
+	{
+		video_decoder decoder;
+		decoder.set_thread_count(settings.decode_thread_count);
+		if (!decoder.open(source) or !decoder.has_stream(stream_type::video))
+		{
+			debug::error("Failed to open {} for proxy generation", source.u8string());
+			return false;
+		}
+
+		auto temp_path = destination;
+		temp_path += ".part";
+
+		std::error_code ec;
+		std::filesystem::create_directories(destination.parent_path(), ec);
+
+		bool success = true;
+		{
+			proxy_encoder encoder;
+			auto duration = decoder.duration();
+			std::optional<int64_t> last_pts;
+
+			while (success)
+			{
+				auto frame = decoder.decode_next_frame();
+				if (!frame.has_value())
+				{
+					break;
+				}
+
+				auto unwrapped_frame = frame->unwrapped();
+				if (!encoder.header_written and !encoder.open(temp_path, unwrapped_frame, settings))
+				{
+					debug::error("Failed to create proxy file {}", temp_path.u8string());
+					success = false;
+				}
+				// The muxer rejects timestamps that go back
+				else if (!last_pts.has_value() or unwrapped_frame->pts > *last_pts)
+				{
+					last_pts = unwrapped_frame->pts;
+					success = encoder.encode(unwrapped_frame);
+				}
+
+				if (success and progress and duration.count() > 0)
+				{
+					success = progress(std::clamp(static_cast<float>(frame->timestamp().count()) / duration.count(), 0.0f, 1.0f));
+				}
+
+				decoder.recycle_frame(std::move(*frame));
+			}
+
+			success = success and encoder.header_written and encoder.finish();
+		}
+
+		if (success)
+		{
+			std::filesystem::rename(temp_path, destination, ec);
+			success = !ec;
+		}
+
+		if (!success)
+		{
+			std::filesystem::remove(temp_path, ec);
+			return false;
+		}
+
+		if (progress)
+		{
+			progress(1.0f);
+		}
+		return true;
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <memory>
+
+namespace vt
+{
+	struct video_proxy_settings
+	{
+		//Proxies are never bigger than the source
+		int max_height = 360;
+		//MJPEG quantizer, 2 is the best quality, 31 the worst
+		int quality = 5;
+		int decode_thread_count = 2;
+	};
+
+	struct video_proxy_data
+	{
+		std::atomic<float> progress = 0.f;
+	};
+
+	//Small intra-only copy of a video, every frame is a keyframe so seeking doesn't have to decode a whole group of pictures
+	//Frames keep the timestamps of the source so both can be used interchangeably
+	struct video_proxy
+	{
+		static constexpr const char* extension = "mkv";
+
+		//progress gets values from 0 to 1, returning false from it cancels the transcode
+		//The proxy is written to a temporary file first, so the destination either holds a complete proxy or nothing
+		static bool generate(const std::filesystem::path& source, const std::filesystem::path& destination, const video_proxy_settings& settings = {}, const std::function<bool(float)>& progress = {});
+	};
+}
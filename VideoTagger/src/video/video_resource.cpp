@@ -40,43 +40,48 @@ namespace vt
 
 	video_resource_metadata make_video_metadata_from_path(const std::filesystem::path& path, make_metadata_include_fields include_fields)
 	{
-		video_stream video;
-		if (!video.open_file(path))
-		{
-			throw std::runtime_error(fmt::format("Failed to open file {}", path.u8string()));
-		}
-
 		video_resource_metadata result;
 		if (include_fields.title)
 		{
 			result.title = path.filename().replace_extension().u8string();
 		}
-		if (include_fields.width)
-		{
-			result.width = video.width();
-		}
-		if (include_fields.height)
-		{
-			result.height = video.height();
-		}
-		if (include_fields.fps)
+
+		std::vector<uint8_t> sha256;
+		if (include_fields.width or include_fields.height or include_fields.fps or include_fields.duration)
 		{
-			result.fps = video.fps();
+			// The file is hashed while it's probed, so it's only read once
+			auto probe = ctx_.probe_cache.probe(path, include_fields.sha256 ? &sha256 : nullptr);
+			if (!probe.has_value())
+			{
+				throw std::runtime_error(fmt::format("Failed to open file {}", path.u8string()));
+			}
+
+			if (include_fields.width)
+			{
+				result.width = probe->width;
+			}
+			if (include_fields.height)
+			{
+				result.height = probe->height;
+			}
+			if (include_fields.fps)
+			{
+				result.fps = probe->fps;
+			}
+			if (include_fields.duration)
+			{
+				result.duration = probe->duration;
+			}
 		}
-		if (include_fields.duration)
+		else if (include_fields.sha256)
 		{
-			result.duration = video.duration();
+			sha256 = ctx_.probe_cache.sha256(path);
 		}
-		video.close();
 
-		if (include_fields.sha256)
+		if (!sha256.empty())
 		{
-			auto sha256 = utils::hash::sha256_file(path);
-			if (!sha256.empty())
-			{
-				result.sha256 = std::array<uint8_t, utils::hash::sha256_byte_count>{};
-				std::copy_n(sha256.begin(), utils::hash::sha256_byte_count, result.sha256->begin());
-			}
+			result.sha256 = std::array<uint8_t, utils::hash::sha256_byte_count>{};
+			std::copy_n(sha256.begin(), utils::hash::sha256_byte_count, result.sha256->begin());
 		}
 
 		return result;
@@ -93,14 +98,13 @@ namespace vt
 	}
 
 	video_resource::video_resource(std::string importer_id, video_id_t id, video_resource_metadata metadata) :
-		importer_id_{ std::move(importer_id) }, id_{ id }, metadata_{ std::move(metadata) }
+		importer_id_{ std::move(importer_id) }, id_{ id }, metadata_{ std::move(metadata) }, hash_verified_{ metadata_.sha256.has_value() }
 	{
 	}
 
 	video_resource::video_resource(std::string importer_id, const nlohmann::ordered_json& json) :
 		importer_id_{ std::move(importer_id) }, id_{ make_video_id_from_json(json) }, metadata_{ make_video_metadata_from_json(json) }
 	{
-		//TODO: could verify the hash
 		if (json.contains("file-path"))
 		{
 			std::string path = json.at("file-path");
@@ -121,6 +125,18 @@ namespace vt
 			fields.sha256 = !metadata_.sha256.has_value();
 
 			write_metadata_fields(metadata_, make_video_metadata_from_path(file_path_, fields), fields);
+
+			// Free if the file didn't change since it was last hashed, otherwise project::schedule_hash_video verifies it
+			auto cached_sha256 = ctx_.probe_cache.cached_sha256(file_path_);
+			if (metadata_.sha256.has_value() and cached_sha256.size() == utils::hash::sha256_byte_count)
+			{
+				if (!std::equal(cached_sha256.begin(), cached_sha256.end(), metadata_.sha256->begin()))
+				{
+					debug::warn("Video {} changed since the project was saved", file_path_);
+					std::copy_n(cached_sha256.begin(), utils::hash::sha256_byte_count, metadata_.sha256->begin());
+				}
+				hash_verified_ = true;
+			}
 		}
 	}
 
@@ -139,14 +155,128 @@ namespace vt
 		return metadata_;
 	}
 
-	const std::optional<gl_texture>& video_resource::thumbnail() const
+	const std::string& video_resource::file_path() const
 	{
-		return thumbnail_;
+		return file_path_;
 	}
 
-	const std::string& video_resource::file_path() const
+	const std::shared_ptr<const frame_index>& video_resource::get_frame_index() const
 	{
-		return file_path_;
+		return frame_index_;
+	}
+
+	const std::optional<utils::hash::file_fingerprint>& video_resource::fingerprint() const
+	{
+		if (!fingerprint_computed_ and !file_path_.empty())
+		{
+			fingerprint_ = utils::hash::fingerprint_file(file_path_);
+			fingerprint_computed_ = true;
+		}
+
+		return fingerprint_;
+	}
+
+	bool video_resource::hash_verified() const
+	{
+		return hash_verified_;
+	}
+
+	std::filesystem::path video_resource::cache_path(const std::string& category, const std::string& extension) const
+	{
+		if (!metadata_.sha256.has_value())
+		{
+			return {};
+		}
+
+		auto filename = utils::hash::bytes_to_hex(*metadata_.sha256, utils::hash::string_case::lower);
+		return (ctx_.cache_dir_filepath / category / filename).replace_extension(extension);
+	}
+
+	std::filesystem::path video_resource::proxy_path() const
+	{
+		return cache_path("proxies", video_proxy::extension);
+	}
+
+	std::filesystem::path video_resource::thumbnail_cache_path() const
+	{
+		return cache_path(fmt::format("thumbnails-{}", thumbnail_max_size), thumbnail_extension);
+	}
+
+	bool video_resource::has_proxy() const
+	{
+		auto path = proxy_path();
+		return !path.empty() and std::filesystem::is_regular_file(path);
+	}
+
+	std::optional<float> video_resource::proxy_progress() const
+	{
+		auto ptr = proxy_data_.lock();
+		if (ptr == nullptr)
+		{
+			return std::nullopt;
+		}
+
+		return ptr->progress;
+	}
+
+	video_filmstrip* video_resource::filmstrip()
+	{
+		if (filmstrip_ == nullptr)
+		{
+			if (!playable() or file_path_.empty() or !metadata_.duration.has_value())
+			{
+				return nullptr;
+			}
+
+			filmstrip_ = std::make_unique<video_filmstrip>(file_path_, cache_path("filmstrips", video_filmstrip::extension), *metadata_.duration);
+		}
+
+		return filmstrip_.get();
+	}
+
+	video_stream video_resource::video() const
+	{
+		auto cached = ctx_.stream_cache.take(id_);
+		if (!cached.has_value())
+		{
+			return open_video();
+		}
+
+		// The index or the proxy might have been created while the stream was cached
+		if (cached->get_frame_index() != frame_index_.get())
+		{
+			cached->set_frame_index(frame_index_);
+		}
+		if (!cached->has_proxy() and has_proxy())
+		{
+			cached->set_proxy_file(proxy_path());
+		}
+
+		cached->seek(std::chrono::nanoseconds{ 0 });
+		return std::move(*cached);
+	}
+
+	std::function<bool()> video_resource::generate_proxy_task(utils::cancellation_token token)
+	{
+		auto destination = proxy_path();
+		if (destination.empty() or !playable())
+		{
+			return nullptr;
+		}
+
+		video_proxy_settings settings;
+		settings.max_height = ctx_.app_settings.proxy_height;
+
+		auto data = std::make_shared<video_proxy_data>();
+		proxy_data_ = data;
+		return [source = std::filesystem::path(file_path()), destination, settings, data, token]()
+		{
+			return video_proxy::generate(source, destination, settings, [&data, &token](float progress)
+			{
+				data->progress = progress;
+				return !token.is_cancelled();
+			});
+		};
 	}
 
 	void video_resource::on_remove() {}
@@ -176,9 +306,64 @@ namespace vt
 			item.name = fmt::format("{} {}", icons::refresh, "Refresh");
 			items.push_back(std::move(item));
 		}
+		if (proxy_progress().has_value())
+		{
+			video_resource_context_menu_item item;
+			item.function = [id = id()]()
+				{
+					ctx_.current_project->cancel_generate_proxy(id);
+				};
+			item.name = fmt::format("{} {}", icons::close, "Cancel Proxy Generation");
+			items.push_back(std::move(item));
+		}
+		else if (playable() and !has_proxy())
+		{
+			video_resource_context_menu_item item;
+			item.function = [id = id()]()
+				{
+					ctx_.current_project->schedule_generate_proxy(id);
+				};
+			item.name = fmt::format("{} {}", icons::video, "Generate Proxy");
+			item.disabled = proxy_path().empty();
+			if (item.disabled)
+			{
+				item.tooltip = "The video has no hash to store the proxy under";
+			}
+			items.push_back(std::move(item));
+		}
 	}
 
-	void video_resource::icon_custom_draw(ImDrawList&, ImRect, ImRect) const {}
+	void video_resource::icon_custom_draw(ImDrawList&, ImRect, ImRect image_rect) const
+	{
+		auto progress = proxy_progress();
+		if (!progress.has_value() and ctx_.current_project.has_value())
+		{
+			// Hashing and indexing report their progress through their job token
+			progress = ctx_.current_project->video_job_progress(id(), video_job_type::hash);
+			if (!progress.has_value())
+			{
+				progress = ctx_.current_project->video_job_progress(id(), video_job_type::frame_index);
+			}
+		}
+
+		if (!progress.has_value())
+		{
+			return;
+		}
+
+		auto& style = ImGui::GetStyle();
+		ImVec2 progress_bar_size = { image_rect.GetWidth(), 5.f };
+
+		ImGui::SetCursorScreenPos(image_rect.Max - progress_bar_size);
+
+		ImGui::PushStyleVar(ImGuiStyleVar_FrameBorderSize, style.ChildBorderSize);
+		ImGui::PushStyleColor(ImGuiCol_PlotHistogram, ImVec4{ 0.0f, 0.5f, 0.9f, 1.0f });
+
+		ImGui::ProgressBar(*progress, progress_bar_size, "");
+
+		ImGui::PopStyleColor();
+		ImGui::PopStyleVar();
+	}
 
 	std::function<void()> video_resource::on_refresh_task()
 	{
@@ -210,22 +395,21 @@ namespace vt
 		if (metadata.sha256.has_value())
 		{
 			metadata_.sha256 = metadata.sha256;
+			hash_verified_ = true;
 		}
 	}
 
-	void video_resource::set_thumbnail(gl_texture&& texture)
-	{
-		thumbnail_ = std::move(texture);
-	}
-
 	void video_resource::set_file_path(const std::string& file_path)
 	{
 		file_path_ = file_path;
+		fingerprint_.reset();
+		fingerprint_computed_ = false;
+		filmstrip_.reset();
 	}
 
-	void video_resource::remove_thumbnail()
+	void video_resource::set_frame_index(std::shared_ptr<const frame_index> index)
 	{
-		thumbnail_.reset();
+		frame_index_ = std::move(index);
 	}
 
 	nlohmann::ordered_json video_resource::save() const
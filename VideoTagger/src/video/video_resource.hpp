@@ -7,7 +7,11 @@
 #include <nlohmann/json.hpp>
 #include <core/gl_texture.hpp>
 #include "video_stream.hpp"
+#include "video_proxy.hpp"
+#include "video_thumbnail.hpp"
+#include "video_filmstrip.hpp"
 #include <utils/hash.hpp>
+#include <utils/job_scheduler.hpp>
 #include <imgui.h>
 
 namespace vt
@@ -62,33 +66,56 @@ namespace vt
 		const std::string& importer_id() const;
 		video_id_t id() const;
 		const video_resource_metadata& metadata() const;
-		const std::optional<gl_texture>& thumbnail() const;
 		const std::string& file_path() const;
+		const std::shared_ptr<const frame_index>& get_frame_index() const;
+		//Computed on first use and kept, nullopt if the video has no readable file
+		const std::optional<utils::hash::file_fingerprint>& fingerprint() const;
+		//False if the hash is missing or came from a project file and wasn't checked against the file yet
+		bool hash_verified() const;
+		//Returns the path of a file in the per-video cache, empty if the video has no hash
+		std::filesystem::path cache_path(const std::string& category, const std::string& extension) const;
+		std::filesystem::path proxy_path() const;
+		std::filesystem::path thumbnail_cache_path() const;
+		bool has_proxy() const;
+		std::optional<float> proxy_progress() const;
+		//Created when it's first needed, nullptr if the video isn't playable
+		video_filmstrip* filmstrip();
 
 		virtual bool playable() const = 0;
-		virtual video_stream video() const = 0;
+		//Reuses the stream from ctx_.stream_cache if the video was displayed recently
+		video_stream video() const;
 		virtual void context_menu_items(std::vector<video_resource_context_menu_item>& items);
 		virtual void icon_custom_draw(ImDrawList& draw_list, ImRect item_rect, ImRect image_rect) const;
 		virtual void on_remove();
 		
-		virtual std::function<bool()> update_thumbnail_task() = 0; //TODO: use a task class
+		//Runs on ctx_.jobs, the task is empty if the video can't have a thumbnail
+		virtual thumbnail_task update_thumbnail_task() = 0;
 		virtual std::function<void()> on_refresh_task(); //TODO: use a task class
+		//Runs on ctx_.jobs and stops once the token is cancelled, the task is empty if the video can't have a proxy
+		std::function<bool()> generate_proxy_task(utils::cancellation_token token);
 
 		void set_metadata(const video_resource_metadata& metadata);
-		void set_thumbnail(gl_texture&& texture);
 		void set_file_path(const std::string& file_path);
-		void remove_thumbnail();
+		void set_frame_index(std::shared_ptr<const frame_index> index);
 
 		nlohmann::ordered_json save() const;
 		//when overloading call the function from parent
 		virtual void on_save(nlohmann::ordered_json& json) const;
 
+	protected:
+		virtual video_stream open_video() const = 0;
+
 	private:
 		video_id_t id_;
 		std::string importer_id_;
 		video_resource_metadata metadata_;
-		std::optional<gl_texture> thumbnail_;
 		std::string file_path_;
+		std::shared_ptr<const frame_index> frame_index_;
+		std::weak_ptr<video_proxy_data> proxy_data_;
+		std::unique_ptr<video_filmstrip> filmstrip_;
+		bool hash_verified_{};
+		mutable std::optional<utils::hash::file_fingerprint> fingerprint_;
+		mutable bool fingerprint_computed_{};
 	};
 
 	inline constexpr void write_metadata_fields(video_resource_metadata& target, const video_resource_metadata& source, make_metadata_include_fields fields)
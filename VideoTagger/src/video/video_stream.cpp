@@ -23,6 +23,13 @@ namespace vt
 		duration_ = decoder_.duration();
 
 		last_ts_ = std::chrono::nanoseconds{ 0 };
+		requested_ts_ = std::chrono::nanoseconds{ 0 };
+
+		frame_cache_ = std::make_unique<frame_cache>(frame_cache_budget_, decoder_.frame_pool());
+		pipeline_ = std::make_unique<frame_pipeline>(decoder_);
+		pipeline_->set_scale_thread_count(scale_thread_count_);
+		pipeline_->set_frame_cache(decoder_.get_decode_mode().is_full() ? frame_cache_.get() : nullptr);
+		decoder_synced_ = true;
 
 		return true;
 	}
@@ -31,8 +38,16 @@ namespace vt
 	{
 		set_playing(false);
 
+		pipeline_.reset();
+		frame_cache_.reset();
 		frame_converter_.reset();
+		proxy_.reset();
+		last_frame.reset();
+		converted_width_ = 0;
+		converted_height_ = 0;
+		seek_pending_ = false;
 		last_ts_ = std::chrono::nanoseconds(0);
+		requested_ts_ = std::chrono::nanoseconds(0);
 		
 		//width_ = 0;
 		//height_ = 0;
@@ -41,11 +56,72 @@ namespace vt
 		decoder_.close();
 	}
 
+	video_stream::video_stream(video_stream&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
 	video_stream::~video_stream()
 	{
 		close();
 	}
 
+	video_stream& video_stream::operator=(video_stream&& other) noexcept
+	{
+		if (this == &other)
+		{
+			return *this;
+		}
+
+		close();
+
+		// The pipeline keeps a pointer to the decoder, so it has to be stopped before the decoder moves
+		if (other.pipeline_ != nullptr)
+		{
+			other.stop_pipeline();
+		}
+
+		decoder_ = std::move(other.decoder_);
+		pipeline_ = std::move(other.pipeline_);
+		if (pipeline_ != nullptr)
+		{
+			pipeline_->set_decoder(decoder_);
+		}
+
+		frame_cache_ = std::move(other.frame_cache_);
+		frame_cache_budget_ = other.frame_cache_budget_;
+		decoder_synced_ = other.decoder_synced_;
+		frame_converter_ = std::move(other.frame_converter_);
+		scale_thread_count_ = other.scale_thread_count_;
+		proxy_ = std::move(other.proxy_);
+		conversion_buffer = std::move(other.conversion_buffer);
+		converted_width_ = other.converted_width_;
+		converted_height_ = other.converted_height_;
+		converted_row_length_ = other.converted_row_length_;
+		last_frame = std::move(other.last_frame);
+		frame_generation_ = other.frame_generation_;
+		last_ts_ = other.last_ts_;
+		requested_ts_ = other.requested_ts_;
+		seek_pending_ = other.seek_pending_;
+		seek_target_ = other.seek_target_;
+		width_ = other.width_;
+		height_ = other.height_;
+		fps_ = other.fps_;
+		duration_ = other.duration_;
+		playing_ = other.playing_;
+
+		other.frame_converter_.reset();
+		other.last_frame.reset();
+		other.playing_ = false;
+
+		if (playing_ and pipeline_ != nullptr)
+		{
+			start_pipeline();
+		}
+
+		return *this;
+	}
+
 	void video_stream::set_playing(bool value)
 	{
 		if (!is_open())
@@ -54,140 +130,285 @@ namespace vt
 		}
 
 		playing_ = value;
+
+		if (using_proxy())
+		{
+			proxy_->set_playing(value);
+			return;
+		}
+
+		if (playing_)
+		{
+			start_pipeline();
+		}
+		else if (seek_pending_)
+		{
+			// The seek is still picked up by poll_seek
+			pipeline_->pause();
+		}
+		else
+		{
+			stop_pipeline();
+		}
 	}
 
 	void video_stream::update(std::chrono::nanoseconds target_timestamp)
 	{
-		//TODO: drop frames
-
 		if (!is_open() or !is_playing())
 		{
 			return;
 		}
 
-		while (!decoder_.eof())
+		requested_ts_ = target_timestamp;
+		if (using_proxy())
 		{
-			if (decoder_.packet_queue_size(stream_type::video) == 0)
-			{
-				//TODO: this probably should be a function in the decoder class
-				decoder_.read_packet();
-				if (decoder_.eof())
-				{
-					continue;
-				}
+			proxy_->update(target_timestamp);
+			last_ts_ = proxy_->current_timestamp();
+			playing_ = proxy_->is_playing();
+			return;
+		}
 
-				if (decoder_.last_read_packet_type() != stream_type::video)
-				{
-					decoder_.discard_last_read_packet();
-					continue;
-				}
-				//---
-			}
+		// Queued frames belong to the old position until the seek is done
+		if (poll_seek())
+		{
+			return;
+		}
+
+		auto frame = pipeline_->take_frame(target_timestamp);
+		if (frame.has_value())
+		{
+			set_pipeline_frame(std::move(*frame));
+		}
+		else if (pipeline_->finished())
+		{
+			set_playing(false);
+		}
+	}
+
+	void video_stream::seek(std::chrono::nanoseconds target_timestamp)
+	{
+		if (!is_open())
+		{
+			return;
+		}
 
-			auto& packet_queue = decoder_.get_packet_queue(stream_type::video);
-			auto& packet = packet_queue.front();
-			if (packet.timestamp() > target_timestamp)
+		requested_ts_ = target_timestamp;
+		if (using_proxy())
+		{
+			proxy_->seek(target_timestamp);
+			last_ts_ = proxy_->current_timestamp();
+			// The video itself is decoded again when the proxy stops being used
+			decoder_synced_ = false;
+			return;
+		}
+
+		stop_pipeline();
+
+		// The target might already be among the frames the pipeline decoded ahead
+		if (decoder_synced_ and last_frame.has_value() and target_timestamp >= last_ts_)
+		{
+			auto frame = pipeline_->take_frame(target_timestamp);
+			if (frame.has_value())
 			{
-				return;
+				set_pipeline_frame(std::move(*frame));
 			}
 
-			if (packet.timestamp() >= last_ts_)
+			if (pipeline_->queue_size() > 0)
 			{
-				if (packet.timestamp() + frame_time() > target_timestamp)
+				if (is_playing())
 				{
-					break;
+					start_pipeline();
 				}
+				return;
 			}
-
-			decoder_.discard_next_packet(stream_type::video);
 		}
 
-		if (decoder_.eof())
+		pipeline_->flush();
+
+		auto cached_frame = frame_cache_->find(target_timestamp, frame_time());
+		if (cached_frame.has_value())
 		{
-			set_playing(false);
-			return;
-		}
+			set_last_frame(std::move(*cached_frame));
 
-		auto decode_result = decoder_.decode_next_packet<stream_type::video>();
-		if (!decode_result.has_value())
+			// The decoder is moved to the frame only when it's needed again
+			decoder_synced_ = false;
+		}
+		else
 		{
-			return;
+			sync_decoder(target_timestamp);
 		}
 
-		last_frame = std::move(decode_result);
-		last_ts_ = last_frame->timestamp();
+		if (is_playing())
+		{
+			start_pipeline();
+		}
 	}
 
-	void video_stream::seek(std::chrono::nanoseconds target_timestamp)
+	void video_stream::seek_async(std::chrono::nanoseconds target_timestamp)
 	{
 		if (!is_open())
 		{
 			return;
 		}
 
-		if (target_timestamp < last_ts_)
+		requested_ts_ = target_timestamp;
+		if (using_proxy())
 		{
-			decoder_.seek_keyframe(0);
-			last_ts_ = std::chrono::nanoseconds(0);
+			proxy_->seek_async(target_timestamp);
+			last_ts_ = proxy_->current_timestamp();
+			decoder_synced_ = false;
+			return;
 		}
-		
-		while (!decoder_.eof())
+
+		// The target might already be among the frames the pipeline decoded ahead
+		if (!seek_pending_ and decoder_synced_ and last_frame.has_value() and target_timestamp >= last_ts_)
 		{
-			decoder_.read_packet();
-			if (decoder_.last_read_packet_type() != stream_type::video)
+			auto frame = pipeline_->take_frame(target_timestamp);
+			if (frame.has_value())
 			{
-				decoder_.discard_last_read_packet();
-				continue;
+				set_pipeline_frame(std::move(*frame));
 			}
 
-			auto& packet = decoder_.peek_last_read_packet();
-
-			if (packet.is_key())
+			if (pipeline_->queue_size() > 0)
 			{
-				while (decoder_.packet_queue_size(stream_type::video) > 1)
-				{
-					decoder_.discard_next_packet(stream_type::video);
-				}
+				return;
 			}
+		}
 
-			if (packet.timestamp() < target_timestamp)
+		auto cached_frame = frame_cache_->find(target_timestamp, frame_time());
+		if (cached_frame.has_value())
+		{
+			set_last_frame(std::move(*cached_frame));
+
+			// Nothing is decoding, so the decoder is moved to the frame only when it's needed again
+			if (!seek_pending_ and !is_playing())
 			{
-				continue;
+				stop_pipeline();
+				pipeline_->flush();
+				decoder_synced_ = false;
+				return;
 			}
-
-			break;
 		}
-
-		while (decoder_.packet_queue_size(stream_type::video) > 0)
+		else
 		{
-			auto decode_result = decoder_.decode_next_packet<stream_type::video>();
-			if (!decode_result.has_value())
+			// Shown until the exact frame is decoded
+			auto nearest_frame = frame_cache_->find_nearest(target_timestamp);
+			if (nearest_frame.has_value())
 			{
-				continue;
+				set_last_frame(std::move(*nearest_frame));
 			}
+		}
+
+		pipeline_->request_seek(target_timestamp);
+		if (is_playing())
+		{
+			pipeline_->start();
+		}
+
+		seek_pending_ = true;
+		seek_target_ = target_timestamp;
+		// The pipeline moves the decoder to the target
+		decoder_synced_ = true;
+	}
+
+	bool video_stream::poll_seek()
+	{
+		if (using_proxy())
+		{
+			return proxy_->poll_seek();
+		}
+
+		if (!seek_pending_ or pipeline_->seeking())
+		{
+			return seek_pending_;
+		}
 
-			last_frame = std::move(decode_result);
-			last_ts_ = last_frame->timestamp();
+		seek_pending_ = false;
+		auto frame = pipeline_->take_frame(seek_target_);
+		if (frame.has_value())
+		{
+			set_pipeline_frame(std::move(*frame));
+		}
+		return false;
+	}
+
+	bool video_stream::seek_pending() const
+	{
+		if (using_proxy())
+		{
+			return proxy_->seek_pending();
 		}
+
+		return seek_pending_;
 	}
 
 	void video_stream::get_frame(gl_texture& texture)
 	{
+		prepare_frame(texture.width(), texture.height());
+		upload_frame(texture);
+	}
+
+	void video_stream::prepare_frame(int width, int height)
+	{
+		if (using_proxy())
+		{
+			proxy_->prepare_frame(width, height);
+			return;
+		}
+
 		if (!last_frame.has_value())
 		{
 			return;
 		}
 
+		if (pipeline_ != nullptr)
+		{
+			pipeline_->set_output_size(width, height);
+		}
+
+		// The pipeline already converted this frame
+		if (converted_width_ == width and converted_height_ == height)
+		{
+			return;
+		}
+
 		auto& frame = *last_frame;
 
-		if (frame_converter_ == std::nullopt or frame_converter_->destination_width() != texture.width() or frame_converter_->destination_height() != texture.height())
+		if (frame_converter_ == std::nullopt or frame_converter_->source_width() != frame.width() or frame_converter_->source_height() != frame.height()
+			or frame_converter_->source_format() != frame.pixel_format() or frame_converter_->destination_width() != width or frame_converter_->destination_height() != height
+			or frame_converter_->thread_count() != scale_thread_count_)
 		{
-			frame_converter_ = frame_converter(width_, height_, frame.pixel_format(), texture.width(), texture.height(), AV_PIX_FMT_RGB24);
+			frame_converter_.emplace(frame.width(), frame.height(), frame.pixel_format(), width, height, AV_PIX_FMT_RGB24, scale_thread_count_);
 		}
 
 		frame_converter_->convert_frame(frame, conversion_buffer);
+		converted_width_ = width;
+		converted_height_ = height;
+		converted_row_length_ = frame_converter_->destination_row_length();
+	}
+
+	void video_stream::upload_frame(gl_texture& texture)
+	{
+		if (using_proxy())
+		{
+			proxy_->upload_frame(texture);
+			return;
+		}
 
-		texture.set_pixels(conversion_buffer.data());
+		if (converted_width_ == texture.width() and converted_height_ == texture.height())
+		{
+			texture.set_pixels(conversion_buffer.data(), converted_row_length_);
+		}
+	}
+
+	uint64_t video_stream::frame_generation() const
+	{
+		if (using_proxy())
+		{
+			return frame_generation_ + proxy_->frame_generation();
+		}
+
+		return frame_generation_;
 	}
 
 	bool video_stream::is_open() const
@@ -235,18 +456,366 @@ namespace vt
 		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(1.0 / fps()));;
 	}
 
-	void video_stream::get_thumbnail(gl_texture& texture, std::optional<std::chrono::nanoseconds> timestamp)
+	void video_stream::set_frame_index(std::shared_ptr<const frame_index> index)
+	{
+		if (!is_open())
+		{
+			return;
+		}
+
+		stop_pipeline();
+		decoder_.set_frame_index(std::move(index));
+
+		if (is_playing())
+		{
+			start_pipeline();
+		}
+	}
+
+	const frame_index* video_stream::get_frame_index() const
+	{
+		return decoder_.get_frame_index();
+	}
+
+	std::chrono::nanoseconds video_stream::frame_number_to_timestamp(size_t frame) const
+	{
+		return decoder_.frame_number_to_timestamp(frame);
+	}
+
+	size_t video_stream::timestamp_to_frame_number(std::chrono::nanoseconds timestamp) const
+	{
+		return decoder_.timestamp_to_frame_number(timestamp);
+	}
+
+	void video_stream::set_decode_mode(const decode_mode& mode, bool refresh_frame)
+	{
+		if (decoder_.get_decode_mode() == mode)
+		{
+			return;
+		}
+
+		if (!is_open())
+		{
+			decoder_.set_decode_mode(mode);
+			return;
+		}
+
+		bool was_using_proxy = using_proxy();
+		if (was_using_proxy)
+		{
+			proxy_->set_playing(false);
+			// Keeps the generation increasing when the proxy's frame isn't displayed anymore
+			frame_generation_ += proxy_->frame_generation();
+		}
+
+		stop_pipeline();
+		pipeline_->flush();
+
+		decoder_.set_decode_mode(mode);
+		// Reduced quality frames shouldn't be shown later when the full quality is expected
+		pipeline_->set_frame_cache(mode.is_full() ? frame_cache_.get() : nullptr);
+		decoder_synced_ = false;
+
+		if (was_using_proxy != using_proxy())
+		{
+			++frame_generation_;
+		}
+
+		// Preview modes can stop at the keyframe before the requested frame, so the refresh goes to what was asked for
+		if ((refresh_frame or was_using_proxy != using_proxy()) and last_frame.has_value())
+		{
+			seek(requested_ts_);
+		}
+		set_playing(playing_);
+	}
+
+	bool video_stream::set_proxy_file(const std::filesystem::path& filepath)
+	{
+		if (using_proxy())
+		{
+			frame_generation_ += proxy_->frame_generation();
+		}
+		++frame_generation_;
+
+		if (proxy_ != nullptr)
+		{
+			proxy_->set_playing(false);
+		}
+
+		if (filepath.empty())
+		{
+			proxy_.reset();
+			return true;
+		}
+
+		auto proxy = std::make_unique<video_stream>();
+		if (!proxy->open_file(filepath))
+		{
+			debug::warn("Failed to open proxy {}", filepath.u8string());
+			proxy_.reset();
+			return false;
+		}
+
+		proxy->set_frame_cache_budget(frame_cache_budget_);
+		proxy->set_scale_thread_count(scale_thread_count_);
+		proxy_ = std::move(proxy);
+
+		if (using_proxy())
+		{
+			proxy_->seek(requested_ts_);
+			proxy_->set_playing(playing_);
+		}
+		return true;
+	}
+
+	bool video_stream::has_proxy() const
+	{
+		return proxy_ != nullptr;
+	}
+
+	bool video_stream::using_proxy() const
+	{
+		return proxy_ != nullptr and !decoder_.get_decode_mode().is_full();
+	}
+
+	const decode_mode& video_stream::get_decode_mode() const
 	{
-		auto start_timestamp = current_timestamp();
+		return decoder_.get_decode_mode();
+	}
+
+	void video_stream::set_decode_thread_count(int count)
+	{
+		if (decoder_.thread_count() == std::max(count, 1))
+		{
+			return;
+		}
+
+		if (!is_open())
+		{
+			decoder_.set_thread_count(count);
+			return;
+		}
+
+		stop_pipeline();
+		pipeline_->flush();
+
+		decoder_.set_thread_count(count);
+		decoder_synced_ = false;
+
+		if (is_playing())
+		{
+			start_pipeline();
+		}
+	}
+
+	int video_stream::decode_thread_count() const
+	{
+		return decoder_.thread_count();
+	}
+
+	void video_stream::set_scale_thread_count(int count)
+	{
+		scale_thread_count_ = std::max(count, 1);
+		if (proxy_ != nullptr)
+		{
+			proxy_->set_scale_thread_count(count);
+		}
+
+		// The converters are recreated with the new count when they convert the next frame
+		if (pipeline_ != nullptr)
+		{
+			pipeline_->set_scale_thread_count(scale_thread_count_);
+		}
+	}
+
+	int video_stream::scale_thread_count() const
+	{
+		return scale_thread_count_;
+	}
+
+	void video_stream::set_frame_cache_budget(size_t budget_bytes)
+	{
+		frame_cache_budget_ = budget_bytes;
+		if (proxy_ != nullptr)
+		{
+			proxy_->set_frame_cache_budget(budget_bytes);
+		}
+
+		if (frame_cache_ != nullptr)
+		{
+			frame_cache_->set_budget(budget_bytes);
+		}
+	}
 
-		if (!timestamp.has_value())
+	frame_cache_stats video_stream::cache_stats() const
+	{
+		if (frame_cache_ == nullptr)
+		{
+			return {};
+		}
+
+		return frame_cache_->stats();
+	}
+
+	object_pool_stats video_stream::packet_pool_stats() const
+	{
+		return decoder_.packet_pool_stats();
+	}
+
+	object_pool_stats video_stream::frame_pool_stats() const
+	{
+		return decoder_.frame_pool_stats();
+	}
+
+	frame_pipeline_stats video_stream::pipeline_stats() const
+	{
+		if (pipeline_ == nullptr)
+		{
+			return {};
+		}
+
+		return pipeline_->stats();
+	}
+
+	void video_stream::sync_decoder(std::chrono::nanoseconds target_timestamp)
+	{
+		bool seek_keyframe = !decoder_synced_ or !last_frame.has_value() or target_timestamp < last_ts_;
+		auto index = decoder_.get_frame_index();
+		if (!seek_keyframe and index != nullptr)
+		{
+			// Jumping to a keyframe is faster than demuxing everything in between
+			seek_keyframe = index->keyframe_before(index->frame_number(target_timestamp)) > index->frame_number(last_ts_);
+		}
+
+		if (seek_keyframe)
+		{
+			decoder_.seek_keyframe(target_timestamp);
+			last_ts_ = std::chrono::nanoseconds(0);
+		}
+		
+		// Only demux until the target, decoding starts from the last keyframe before it
+		while (!decoder_.eof())
+		{
+			decoder_.read_packet();
+			if (decoder_.eof())
+			{
+				break;
+			}
+
+			if (decoder_.last_read_packet_type() != stream_type::video)
+			{
+				decoder_.discard_last_read_packet();
+				continue;
+			}
+
+			auto& packet = decoder_.peek_last_read_packet();
+			if (packet.timestamp() >= target_timestamp)
+			{
+				break;
+			}
+
+			if (packet.is_key())
+			{
+				while (decoder_.packet_queue_size(stream_type::video) > 1)
+				{
+					decoder_.discard_next_packet(stream_type::video);
+				}
+				decoder_.flush_codecs();
+			}
+		}
+
+		// Frames come out in presentation order, the target is the last one that isn't past the timestamp
+		bool found_frame = false;
+		while (true)
+		{
+			auto frame = decoder_.decode_next_frame();
+			if (!frame.has_value())
+			{
+				break;
+			}
+
+			if (decoder_.get_decode_mode().is_full())
+			{
+				frame_cache_->insert(*frame);
+			}
+
+			if (found_frame and frame->timestamp() > target_timestamp)
+			{
+				// Already decoded, so the pipeline continues from it instead of throwing it away
+				pipeline_->push_frame(std::move(*frame));
+				break;
+			}
+
+			set_last_frame(std::move(*frame));
+			found_frame = true;
+			// Queued packets start at the last keyframe before the target, so there's nothing closer
+			if (last_ts_ > target_timestamp or decoder_.get_decode_mode().keyframes_only)
+			{
+				break;
+			}
+		}
+
+		decoder_synced_ = true;
+	}
+
+	void video_stream::set_last_frame(video_frame&& frame)
+	{
+		if (last_frame.has_value())
+		{
+			decoder_.recycle_frame(std::move(*last_frame));
+		}
+
+		last_frame = std::move(frame);
+		last_ts_ = last_frame->timestamp();
+		++frame_generation_;
+		converted_width_ = 0;
+		converted_height_ = 0;
+	}
+
+	void video_stream::set_pipeline_frame(pipeline_frame&& frame)
+	{
+		set_last_frame(std::move(frame.frame));
+
+		conversion_buffer.swap(frame.pixels);
+		converted_width_ = frame.width;
+		converted_height_ = frame.height;
+		converted_row_length_ = frame.row_length;
+		pipeline_->recycle_pixels(std::move(frame.pixels));
+	}
+
+	void video_stream::stop_pipeline()
+	{
+		pipeline_->stop();
+		if (!seek_pending_)
+		{
+			return;
+		}
+
+		seek_pending_ = false;
+		if (!pipeline_->seeking())
+		{
+			auto frame = pipeline_->take_frame(seek_target_);
+			if (frame.has_value())
+			{
+				set_pipeline_frame(std::move(*frame));
+			}
+			return;
+		}
+
+		// Abandoned halfway, the decoder is somewhere before the target
+		pipeline_->flush();
+		decoder_synced_ = false;
+		last_ts_ = seek_target_;
+	}
+
+	void video_stream::start_pipeline()
+	{
+		if (!decoder_synced_)
 		{
-			timestamp = duration() / 2;
+			sync_decoder(last_ts_);
 		}
 
-		seek(*timestamp);
-		get_frame(texture);
-		seek(start_timestamp);
+		pipeline_->start();
 	}
 
 	void video_stream::clear_yuv_texture(GLuint texture, uint8_t r, uint8_t g, uint8_t b)
@@ -4,12 +4,15 @@
 #include <chrono>
 #include <deque>
 #include <optional>
+#include <memory>
 #include <SDL.h>
 #include <SDL_opengl.h>
 #include <core/gl_texture.hpp>
 
 #include "video_decoder.hpp"
 #include "frame_converter.hpp"
+#include "frame_pipeline.hpp"
+#include "frame_cache.hpp"
 
 namespace vt
 {
@@ -18,11 +21,11 @@ namespace vt
 	public:
 		video_stream() = default;
 		video_stream(const video_stream&) = delete;
-		video_stream(video_stream&&) = default;
+		video_stream(video_stream&& other) noexcept;
 		~video_stream();
 
 		video_stream& operator=(const video_stream&) = delete;
-		video_stream& operator=(video_stream&&) = default;
+		video_stream& operator=(video_stream&& other) noexcept;
 
 		bool open_file(const std::filesystem::path& filepath);
 		void close();
@@ -31,9 +34,21 @@ namespace vt
 
 		void update(std::chrono::nanoseconds target_timestamp);
 		void seek(std::chrono::nanoseconds target_timestamp);
+		//Doesn't wait for the decoder, the nearest cached frame is shown until poll_seek or update picks up the exact one
+		//A newer seek cancels the one that is still being decoded
+		void seek_async(std::chrono::nanoseconds target_timestamp);
+		//Shows the frame of a finished seek_async, returns true while it's still decoding
+		bool poll_seek();
+		[[nodiscard]] bool seek_pending() const;
 
 		//texture must be in yuv format, have streaming access and with and height the same as the video
 		void get_frame(gl_texture& texture);
+		//Converts the current frame to the given size, doesn't touch OpenGL so it can run on a worker thread
+		void prepare_frame(int width, int height);
+		//Uploads the frame converted by prepare_frame, the texture must have the size it was prepared for
+		void upload_frame(gl_texture& texture);
+		//Changes every time the frame returned by get_frame changes, so unchanged frames don't have to be uploaded again
+		[[nodiscard]] uint64_t frame_generation() const;
 
 		[[nodiscard]] bool is_open() const;
 
@@ -49,20 +64,66 @@ namespace vt
 		double fps() const;
 		std::chrono::nanoseconds frame_time() const;
 
-		void get_thumbnail(gl_texture& texture, std::optional<std::chrono::nanoseconds> timestamp = std::nullopt);
+		void set_frame_index(std::shared_ptr<const frame_index> index);
+		[[nodiscard]] const frame_index* get_frame_index() const;
+
+		//Uses the frame index if it's available, otherwise assumes constant frame rate
+		[[nodiscard]] std::chrono::nanoseconds frame_number_to_timestamp(size_t frame) const;
+		[[nodiscard]] size_t timestamp_to_frame_number(std::chrono::nanoseconds timestamp) const;
+
+		[[nodiscard]] frame_pipeline_stats pipeline_stats() const;
+		[[nodiscard]] object_pool_stats packet_pool_stats() const;
+		[[nodiscard]] object_pool_stats frame_pool_stats() const;
+
+		//The proxy is played instead of the video whenever the decode mode isn't full, an empty path removes it
+		bool set_proxy_file(const std::filesystem::path& filepath);
+		[[nodiscard]] bool has_proxy() const;
+		[[nodiscard]] bool using_proxy() const;
+
+		//Reduced quality decoding for previews, with refresh_frame the current frame is decoded again in the new mode
+		void set_decode_mode(const decode_mode& mode, bool refresh_frame = true);
+		[[nodiscard]] const decode_mode& get_decode_mode() const;
+
+		//Changing the thread count of an open stream restarts decoding from the nearest keyframe
+		void set_decode_thread_count(int count);
+		[[nodiscard]] int decode_thread_count() const;
+		//Threads used to convert the frames to rgb, 1 converts them on the thread that decodes them
+		void set_scale_thread_count(int count);
+		[[nodiscard]] int scale_thread_count() const;
+
+		//Budget of 0 disables caching of decoded frames
+		void set_frame_cache_budget(size_t budget_bytes);
+		[[nodiscard]] frame_cache_stats cache_stats() const;
 
 		//TODO: should be somewhere in utils
 		static void clear_yuv_texture(GLuint texture, uint8_t r, uint8_t g, uint8_t b);
 
 	private:
 		video_decoder decoder_;
+		std::unique_ptr<frame_pipeline> pipeline_;
+		std::unique_ptr<frame_cache> frame_cache_;
+		size_t frame_cache_budget_{};
+		//False when the displayed frame came from the cache and the decoder is somewhere else
+		bool decoder_synced_ = true;
 		std::optional<frame_converter> frame_converter_;
+		int scale_thread_count_ = 1;
+		//Intra-only low resolution copy of the video, it has the same timestamps
+		std::unique_ptr<video_stream> proxy_;
 
 		std::vector<uint8_t> conversion_buffer;
+		//Size of the frame in conversion_buffer if it was already converted by the pipeline
+		int converted_width_{};
+		int converted_height_{};
+		int converted_row_length_{};
 
 		std::optional<video_frame> last_frame;
+		uint64_t frame_generation_{};
 		//maybe this is not necessary
 		std::chrono::nanoseconds last_ts_{};
+		//Timestamp of the last seek or update, last_ts_ can be before it when only keyframes are decoded
+		std::chrono::nanoseconds requested_ts_{};
+		bool seek_pending_{};
+		std::chrono::nanoseconds seek_target_{};
 
 		int width_{};
 		int height_{};
@@ -70,5 +131,14 @@ namespace vt
 		std::chrono::nanoseconds duration_{};
 
 		bool playing_{};
+
+		//Decodes the frame at the timestamp, the pipeline must be stopped
+		void sync_decoder(std::chrono::nanoseconds target_timestamp);
+		//Stops the pipeline and resolves a pending seek_async, the decoder isn't synced anymore if it didn't finish
+		void stop_pipeline();
+		void start_pipeline();
+		//Gives the previous frame back to the decoder
+		void set_last_frame(video_frame&& frame);
+		void set_pipeline_frame(pipeline_frame&& frame);
 	};
 }
@@ -0,0 +1,79 @@
+#include "pch.hpp"
+#include "video_stream_cache.hpp"
+
+namespace vt
+{
+	video_stream_cache::video_stream_cache(size_t limit) : limit_{ limit }
+	{
+	}
+
+	void video_stream_cache::set_limit(size_t limit)
+	{
+		limit_ = limit;
+		evict(limit_);
+	}
+
+	void video_stream_cache::insert(video_id_t video_id, video_stream&& stream)
+	{
+		if (limit_ == 0 or !stream.is_open())
+		{
+			return;
+		}
+
+		erase(video_id);
+		evict(limit_ - 1);
+
+		// Decoded frames would take a lot of memory for a video that isn't displayed
+		stream.set_playing(false);
+		stream.set_frame_cache_budget(0);
+		entries_.emplace_front(video_id, std::move(stream));
+	}
+
+	std::optional<video_stream> video_stream_cache::take(video_id_t video_id)
+	{
+		auto it = std::find_if(entries_.begin(), entries_.end(), [video_id](const auto& entry) { return entry.first == video_id; });
+		if (it == entries_.end())
+		{
+			++misses_;
+			return std::nullopt;
+		}
+
+		++hits_;
+		std::optional<video_stream> result = std::move(it->second);
+		entries_.erase(it);
+		return result;
+	}
+
+	void video_stream_cache::erase(video_id_t video_id)
+	{
+		entries_.remove_if([video_id](const auto& entry) { return entry.first == video_id; });
+	}
+
+	void video_stream_cache::clear()
+	{
+		entries_.clear();
+	}
+
+	bool video_stream_cache::contains(video_id_t video_id) const
+	{
+		return std::any_of(entries_.begin(), entries_.end(), [video_id](const auto& entry) { return entry.first == video_id; });
+	}
+
+	video_stream_cache_stats video_stream_cache::stats() const
+	{
+		video_stream_cache_stats result;
+		result.hits = hits_;
+		result.misses = misses_;
+		result.size = entries_.size();
+		result.limit = limit_;
+		return result;
+	}
+
+	void video_stream_cache::evict(size_t limit)
+	{
+		while (entries_.size() > limit)
+		{
+			entries_.pop_back();
+		}
+	}
+}
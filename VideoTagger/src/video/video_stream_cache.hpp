@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <list>
+#include <optional>
+#include <utility>
+
+#include "video_stream.hpp"
+
+namespace vt
+{
+	using video_id_t = uint64_t;
+
+	struct video_stream_cache_stats
+	{
+		uint64_t hits{};
+		uint64_t misses{};
+		size_t size{};
+		size_t limit{};
+	};
+
+	//Keeps streams that aren't displayed anymore open, so showing the video again doesn't have to open and probe the file
+	//The least recently inserted streams are closed when the limit is exceeded
+	class video_stream_cache
+	{
+	public:
+		static constexpr size_t default_limit = 4;
+
+		explicit video_stream_cache(size_t limit = default_limit);
+		video_stream_cache(const video_stream_cache&) = delete;
+		video_stream_cache(video_stream_cache&&) = delete;
+
+		video_stream_cache& operator=(const video_stream_cache&) = delete;
+		video_stream_cache& operator=(video_stream_cache&&) = delete;
+
+		//Limit of 0 disables the cache
+		void set_limit(size_t limit);
+
+		//The stream is paused and its frame cache is emptied, a stream that is already cached for the id is replaced
+		void insert(video_id_t video_id, video_stream&& stream);
+		//Removes the stream from the cache and returns it
+		[[nodiscard]] std::optional<video_stream> take(video_id_t video_id);
+		void erase(video_id_t video_id);
+		void clear();
+
+		[[nodiscard]] bool contains(video_id_t video_id) const;
+		[[nodiscard]] video_stream_cache_stats stats() const;
+
+	private:
+		//Most recently inserted first
+		std::list<std::pair<video_id_t, video_stream>> entries_;
+		size_t limit_;
+
+		uint64_t hits_{};
+		uint64_t misses_{};
+
+		void evict(size_t limit);
+	};
+}
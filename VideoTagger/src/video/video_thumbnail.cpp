@@ -0,0 +1,226 @@
+#include "pch.hpp"
+#include "video_thumbnail.hpp"
+#include "video_decoder.hpp"
+#include "frame_converter.hpp"
+#include <core/debug.hpp>
+
+extern "C"
+{
+	#include <libavcodec/avcodec.h>
+	#include <libswscale/swscale.h>
+}
+
+namespace vt
+{
+	namespace
+	{
+		struct jpeg_codec
+		{
+			AVCodecContext* codec_context{};
+			SwsContext* sws_context{};
+			AVFrame* frame{};
+			AVPacket* packet{};
+
+			~jpeg_codec()
+			{
+				avcodec_free_context(&codec_context);
+				sws_freeContext(sws_context);
+				av_frame_free(&frame);
+				av_packet_free(&packet);
+			}
+
+			bool open(const AVCodec* codec)
+			{
+				codec_context = codec != nullptr ? avcodec_alloc_context3(codec) : nullptr;
+				frame = av_frame_alloc();
+				packet = av_packet_alloc();
+				return codec_context != nullptr and frame != nullptr and packet != nullptr;
+			}
+		};
+	}
+
+	decode_mode thumbnail_decode_mode(int source_width, int source_height, int width, int height)
+	{
+		// The codec halves the resolution for every lowres step
+		auto mode = decode_mode::preview();
+		mode.lowres = 0;
+		while (mode.lowres < 3 and (source_width >> (mode.lowres + 1)) >= width and (source_height >> (mode.lowres + 1)) >= height)
+		{
+			++mode.lowres;
+		}
+		return mode;
+	}
+
+	std::optional<thumbnail_image> decode_thumbnail(const std::filesystem::path& path, int max_size, std::optional<std::chrono::nanoseconds> timestamp)
+	{
+		video_decoder decoder;
+		// Many thumbnails are decoded at the same time, so each one uses a single thread
+		decoder.set_thread_count(1);
+		if (!decoder.open(path) or !decoder.has_stream(stream_type::video))
+		{
+			debug::error("Failed to open video from path {}", path.u8string());
+			return std::nullopt;
+		}
+
+		int width = decoder.width();
+		int height = decoder.height();
+		if (width <= 0 or height <= 0)
+		{
+			return std::nullopt;
+		}
+
+		float scale = std::min(1.0f, static_cast<float>(max_size) / std::max(width, height));
+		thumbnail_image result;
+		result.width = std::max(static_cast<int>(width * scale), 1);
+		result.height = std::max(static_cast<int>(height * scale), 1);
+
+		decoder.set_decode_mode(thumbnail_decode_mode(width, height, result.width, result.height));
+
+		decoder.seek_keyframe(timestamp.value_or(decoder.duration() / 2));
+		auto frame = decoder.decode_next_frame();
+		if (!frame.has_value())
+		{
+			decoder.seek_keyframe(std::chrono::nanoseconds{});
+			frame = decoder.decode_next_frame();
+		}
+
+		if (!frame.has_value())
+		{
+			debug::error("Failed to decode a thumbnail frame from {}", path.u8string());
+			return std::nullopt;
+		}
+
+		frame_converter converter(frame->width(), frame->height(), frame->pixel_format(), result.width, result.height, AV_PIX_FMT_RGB24);
+		converter.convert_frame(*frame, result.pixels);
+		result.row_length = converter.destination_row_length();
+		decoder.recycle_frame(std::move(*frame));
+
+		return result;
+	}
+
+	std::vector<uint8_t> encode_thumbnail_data(const thumbnail_image& image)
+	{
+		jpeg_codec codec;
+		if (!codec.open(avcodec_find_encoder(AV_CODEC_ID_MJPEG)))
+		{
+			return {};
+		}
+
+		auto codec_context = codec.codec_context;
+		codec_context->width = image.width;
+		codec_context->height = image.height;
+		codec_context->pix_fmt = AV_PIX_FMT_YUVJ420P;
+		codec_context->color_range = AVCOL_RANGE_JPEG;
+		codec_context->time_base = AVRational{ 1, 1 };
+		codec_context->flags |= AV_CODEC_FLAG_QSCALE;
+		codec_context->global_quality = FF_QP2LAMBDA * thumbnail_quality;
+		if (avcodec_open2(codec_context, codec_context->codec, nullptr) < 0)
+		{
+			return {};
+		}
+
+		auto frame = codec.frame;
+		frame->format = codec_context->pix_fmt;
+		frame->width = image.width;
+		frame->height = image.height;
+		frame->quality = codec_context->global_quality;
+		codec.sws_context = sws_getContext(image.width, image.height, AV_PIX_FMT_RGB24, image.width, image.height, codec_context->pix_fmt, SWS_BILINEAR, nullptr, nullptr, nullptr);
+		if (codec.sws_context == nullptr or av_frame_get_buffer(frame, 0) < 0)
+		{
+			return {};
+		}
+
+		const uint8_t* source_data[] = { image.pixels.data() };
+		int source_linesize[] = { image.row_length * 3 };
+		sws_scale(codec.sws_context, source_data, source_linesize, 0, image.height, frame->data, frame->linesize);
+
+		if (avcodec_send_frame(codec_context, frame) < 0 or avcodec_send_frame(codec_context, nullptr) < 0 or avcodec_receive_packet(codec_context, codec.packet) < 0)
+		{
+			return {};
+		}
+
+		return std::vector<uint8_t>(codec.packet->data, codec.packet->data + codec.packet->size);
+	}
+
+	std::optional<thumbnail_image> decode_thumbnail_data(const std::vector<uint8_t>& data)
+	{
+		jpeg_codec codec;
+		if (data.empty() or !codec.open(avcodec_find_decoder(AV_CODEC_ID_MJPEG)))
+		{
+			return std::nullopt;
+		}
+
+		auto codec_context = codec.codec_context;
+		codec_context->thread_count = 1;
+		// The packet needs padding after the data, so it's copied
+		if (avcodec_open2(codec_context, codec_context->codec, nullptr) < 0 or av_new_packet(codec.packet, static_cast<int>(data.size())) < 0)
+		{
+			return std::nullopt;
+		}
+		std::copy(data.begin(), data.end(), codec.packet->data);
+
+		if (avcodec_send_packet(codec_context, codec.packet) < 0 or avcodec_send_packet(codec_context, nullptr) < 0 or avcodec_receive_frame(codec_context, codec.frame) < 0)
+		{
+			return std::nullopt;
+		}
+
+		auto frame = codec.frame;
+		codec.sws_context = sws_getContext(frame->width, frame->height, static_cast<AVPixelFormat>(frame->format), frame->width, frame->height, AV_PIX_FMT_RGB24, SWS_BILINEAR, nullptr, nullptr, nullptr);
+		if (codec.sws_context == nullptr)
+		{
+			return std::nullopt;
+		}
+
+		thumbnail_image result;
+		result.width = frame->width;
+		result.height = frame->height;
+		result.row_length = frame->width;
+		result.pixels.resize(static_cast<size_t>(result.width) * result.height * 3);
+
+		uint8_t* destination_data[] = { result.pixels.data() };
+		int destination_linesize[] = { result.row_length * 3 };
+		sws_scale(codec.sws_context, frame->data, frame->linesize, 0, frame->height, destination_data, destination_linesize);
+
+		return result;
+	}
+
+	bool save_thumbnail(const thumbnail_image& image, const std::filesystem::path& path)
+	{
+		auto data = encode_thumbnail_data(image);
+		if (data.empty())
+		{
+			return false;
+		}
+
+		std::error_code error;
+		std::filesystem::create_directories(path.parent_path(), error);
+
+		std::ofstream out(path, std::ios::binary);
+		if (!out.is_open())
+		{
+			return false;
+		}
+
+		out.write(reinterpret_cast<const char*>(data.data()), data.size());
+		return out.good();
+	}
+
+	std::vector<uint8_t> load_thumbnail_data(const std::filesystem::path& path)
+	{
+		std::error_code error;
+		auto size = std::filesystem::file_size(path, error);
+		if (error)
+		{
+			return {};
+		}
+
+		std::ifstream in(path, std::ios::binary);
+		std::vector<uint8_t> result(static_cast<size_t>(size));
+		if (!in.is_open() or !in.read(reinterpret_cast<char*>(result.data()), result.size()))
+		{
+			return {};
+		}
+
+		return result;
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace vt
+{
+	//Longest side of generated thumbnails in pixels, enough for the biggest tiles of the browsers
+	static constexpr int thumbnail_max_size = 256;
+	//MJPEG quantizer of cached thumbnails, 2 is the best quality, 31 the worst
+	static constexpr int thumbnail_quality = 4;
+	static constexpr const char* thumbnail_extension = "jpg";
+
+	//Rgb24 pixels of a thumbnail, decoded on a worker thread and uploaded to a texture on the render thread
+	struct thumbnail_image
+	{
+		int width{};
+		int height{};
+		//Distance between rows in pixels
+		int row_length{};
+		std::vector<uint8_t> pixels;
+	};
+
+	//Generates the thumbnail on a worker thread, returns nullopt on error
+	using thumbnail_task = std::function<std::optional<thumbnail_image>()>;
+
+	struct decode_mode;
+
+	//Preview decode mode with the largest lowres factor that still decodes frames at least as big as the given size
+	[[nodiscard]] extern decode_mode thumbnail_decode_mode(int source_width, int source_height, int width, int height);
+
+	//Decodes the keyframe before the timestamp (the middle of the video by default) with a reduced resolution
+	//and scales it to fit max_size, doesn't touch OpenGL so it can run on a worker thread
+	[[nodiscard]] extern std::optional<thumbnail_image> decode_thumbnail(const std::filesystem::path& path, int max_size = thumbnail_max_size, std::optional<std::chrono::nanoseconds> timestamp = std::nullopt);
+
+	//Compresses the thumbnail to a jpeg image, returns an empty vector on error
+	[[nodiscard]] extern std::vector<uint8_t> encode_thumbnail_data(const thumbnail_image& image);
+	//Decompresses a thumbnail made by encode_thumbnail_data
+	[[nodiscard]] extern std::optional<thumbnail_image> decode_thumbnail_data(const std::vector<uint8_t>& data);
+	//Creates the directory of the file if it doesn't exist
+	extern bool save_thumbnail(const thumbnail_image& image, const std::filesystem::path& path);
+	//Returns an empty vector if the file can't be read
+	[[nodiscard]] extern std::vector<uint8_t> load_thumbnail_data(const std::filesystem::path& path);
+}
@@ -15,7 +15,7 @@ namespace vt::widgets
 	{
 		if (!ctx_.current_project.has_value()) return;
 
-		static auto draw_video_tile = [this](video_id_t id, video_resource& vid_resource, ImVec2 tile_size, bool& open, GLuint image = 0)
+		static auto draw_video_tile = [this](video_id_t id, video_resource& vid_resource, ImVec2 tile_size, bool& open, std::optional<thumbnail_tile> thumbnail = std::nullopt)
 		{
 			const auto& metadata = vid_resource.metadata();
 			std::string label = metadata.title.value_or("");
@@ -23,9 +23,10 @@ namespace vt::widgets
 
 			ImVec2 image_size = image_tile_size;
 
+			GLuint image = 0;
 			ImVec2 uv0{ 0, 0 };
 			ImVec2 uv1{ 1, 1 };
-			if (image == 0)
+			if (!thumbnail.has_value())
 			{
 				image = utils::thumbnail::font_texture();
 				auto glyph = utils::thumbnail::find_glyph(utils::thumbnail::video_icon);
@@ -34,6 +35,10 @@ namespace vt::widgets
 			}
 			else
 			{
+				image = thumbnail->texture;
+				uv0 = thumbnail->uv0;
+				uv1 = thumbnail->uv1;
+
 				float scaled_width = *metadata.width * image_tile_size.y / *metadata.height;
 				float scaled_height = image_tile_size.x * *metadata.height / *metadata.width;
 
@@ -129,7 +134,16 @@ namespace vt::widgets
 									bool open_video{};
 
 									ImGui::TableNextColumn();
-									draw_video_tile(vid_resource->id(), *vid_resource, tile_size, open_video, vid_resource->thumbnail() ? vid_resource->thumbnail()->id() : 0);
+									std::optional<thumbnail_tile> thumbnail;
+									if (ImGui::IsRectVisible(tile_size))
+									{
+										thumbnail = ctx_.current_project->thumbnails.find(vid_resource->id());
+										if (!thumbnail.has_value())
+										{
+											ctx_.current_project->request_thumbnail(vid_resource->id());
+										}
+									}
+									draw_video_tile(vid_resource->id(), *vid_resource, tile_size, open_video, thumbnail);
 									
 									any_item_hovered = any_item_hovered or ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenBlockedByPopup);
 								}
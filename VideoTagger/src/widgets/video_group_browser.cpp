@@ -18,16 +18,17 @@ namespace vt::widgets
 		if (!ctx_.current_project.has_value()) return;
 
 		//TODO: would be nice to just use the fucntion from video_browser
-		static auto draw_video_tile = [this](const video_resource& vid_resource, ImVec2 tile_size, bool& open, bool& remove, bool& properties, GLuint image = 0)
+		static auto draw_video_tile = [this](const video_resource& vid_resource, ImVec2 tile_size, bool& open, bool& remove, bool& properties, std::optional<thumbnail_tile> thumbnail = std::nullopt)
 		{
 			const auto& metadata = vid_resource.metadata();
 
 			ImVec2 image_tile_size{ tile_size.x * 0.9f, tile_size.x * 0.9f };
 
 			ImVec2 image_size = image_tile_size;
+			GLuint image = 0;
 			ImVec2 uv0{ 0, 0 };
 			ImVec2 uv1{ 1, 1 };
-			if (image == 0)
+			if (!thumbnail.has_value())
 			{
 				image = utils::thumbnail::font_texture();
 				auto glyph = utils::thumbnail::find_glyph(utils::thumbnail::video_icon);
@@ -36,6 +37,10 @@ namespace vt::widgets
 			}
 			else
 			{
+				image = thumbnail->texture;
+				uv0 = thumbnail->uv0;
+				uv1 = thumbnail->uv1;
+
 				float scaled_width = *metadata.width * image_tile_size.y / *metadata.height;
 				float scaled_height = image_tile_size.x * *metadata.height / *metadata.width;
 
@@ -450,7 +455,16 @@ namespace vt::widgets
 								}
 
 								ImGui::TableNextColumn();
-								draw_video_tile(vid_resource, tile_size, open_video, remove_video, open_video_properties, vid_resource.thumbnail() ? vid_resource.thumbnail()->id() : 0);
+								std::optional<thumbnail_tile> thumbnail;
+								if (ImGui::IsRectVisible(tile_size))
+								{
+									thumbnail = ctx_.current_project->thumbnails.find(vinfo.id);
+									if (!thumbnail.has_value())
+									{
+										ctx_.current_project->request_thumbnail(vinfo.id);
+									}
+								}
+								draw_video_tile(vid_resource, tile_size, open_video, remove_video, open_video_properties, thumbnail);
 								if (remove_video)
 								{
 									auto& vgroup = ctx_.current_project->video_groups.at(current_video_group);
@@ -16,7 +16,7 @@ namespace vt::widgets
 		return static_cast<size_t>(std::pow(2, std::ceil(std::log2(n))));
 	}
 
-	video_player::video_player() : dock_window_count_{}, speed_{ 1.0f }, is_visible_{}, is_playing_ {}, loop_mode_{} {}
+	video_player::video_player() : dock_window_count_{}, speed_{ 1.0f }, is_visible_{}, is_playing_ {}, is_scrubbing_{}, loop_mode_{} {}
 
 	void video_player::update_data(video_player_data data, bool is_playing)
 	{
@@ -114,13 +114,16 @@ namespace vt::widgets
 			auto progress_size = ImVec2{ ImGui::GetContentRegionAvail().x, text_height };
 			if (has_child_videos)
 			{
-				if (slider_scalar("##VideoProgressBar", ImGuiDataType_U64, progress_size, text_height / 5.f, &data_.current_ts, &min_ts, &data_.end_ts, "", ImGuiSliderFlags_AlwaysClamp))
+				bool value_changed = slider_scalar("##VideoProgressBar", ImGuiDataType_U64, progress_size, text_height / 5.f, &data_.current_ts, &min_ts, &data_.end_ts, "", ImGuiSliderFlags_AlwaysClamp);
+				is_scrubbing_ = ImGui::IsItemActive();
+				if (value_changed)
 				{
 					std::invoke(callbacks.on_seek, data_.current_ts);
 				}
 			}
 			else
 			{
+				is_scrubbing_ = false;
 				ImGui::Dummy(progress_size);
 			}
 
@@ -316,4 +319,9 @@ namespace vt::widgets
 	{
 		return is_playing_;
 	}
+
+	bool video_player::is_scrubbing() const
+	{
+		return is_scrubbing_;
+	}
 }
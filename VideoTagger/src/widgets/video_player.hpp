@@ -44,6 +44,7 @@ namespace vt::widgets
 		float speed_;
 		bool is_visible_;
 		bool is_playing_;
+		bool is_scrubbing_;
 		loop_mode loop_mode_;
 
 	public:
@@ -61,6 +62,8 @@ namespace vt::widgets
 
 		bool is_visible() const;
 		bool is_playing() const;
+		//True while the progress bar is being dragged
+		bool is_scrubbing() const;
 		loop_mode loop_mode() const;
 	};
 }
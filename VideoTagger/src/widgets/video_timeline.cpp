@@ -119,6 +119,11 @@ namespace vt::widgets
 		return current_time_;
 	}
 
+	bool video_timeline::is_scrubbing() const
+	{
+		return moving_time_marker_;
+	}
+
 	static bool timeline_add_button(ImDrawList* draw_list, ImVec2 pos)
 	{
 		//TODO: Use a regular imgui button
@@ -144,6 +149,62 @@ namespace vt::widgets
 		return clickedBtn;
 	}
 
+	struct filmstrip_video
+	{
+		video_filmstrip* filmstrip{};
+		std::chrono::nanoseconds offset{};
+	};
+
+	//Filmstrips of the videos in the group, the textures are updated so the frames can be drawn right away
+	static std::vector<filmstrip_video> group_filmstrips(video_group_id_t group_id)
+	{
+		std::vector<filmstrip_video> result;
+
+		auto& video_groups = ctx_.current_project->video_groups;
+		auto it = video_groups.find(group_id);
+		if (it == video_groups.end())
+		{
+			return result;
+		}
+
+		for (const auto& video_info : it->second)
+		{
+			if (!ctx_.current_project->videos.contains(video_info.id))
+			{
+				continue;
+			}
+
+			auto* filmstrip = ctx_.current_project->videos.get(video_info.id).filmstrip();
+			if (filmstrip != nullptr)
+			{
+				filmstrip->update_texture();
+				result.push_back({ filmstrip, video_info.offset });
+			}
+		}
+		return result;
+	}
+
+	//Frames of every video that is playing at the timestamp, in the order of the group
+	static std::vector<filmstrip_frame> filmstrip_frames_at(const std::vector<filmstrip_video>& videos, std::chrono::nanoseconds timestamp)
+	{
+		std::vector<filmstrip_frame> result;
+		for (const auto& video : videos)
+		{
+			auto local_timestamp = timestamp - video.offset;
+			if (local_timestamp.count() < 0 or local_timestamp >= video.filmstrip->duration())
+			{
+				continue;
+			}
+
+			auto frame = video.filmstrip->find_frame(local_timestamp);
+			if (frame.has_value())
+			{
+				result.push_back(*frame);
+			}
+		}
+		return result;
+	}
+
 	bool merge_segments_popup(const std::string& id, bool& pressed_button, bool display_dragged_segment_text)
 	{
 		//TODO: improve layout
@@ -232,6 +293,8 @@ namespace vt::widgets
 			ImVec2 canvas_size = ImGui::GetContentRegionAvail();        // Resize canvas to what's available
 			int64_t first_frame_used = first_frame_;
 			ImVec2 header_size(canvas_size.x, (float)item_height);
+			const bool show_filmstrip = enabled_ and ctx_.app_settings.show_filmstrip;
+			const float filmstrip_height = show_filmstrip ? 3 * item_height : 0.f;
 			ImVec2 scroll_bar_size(canvas_size.x, style.ScrollbarSize);
 			bool has_scroll_bar = true;
 
@@ -241,7 +304,6 @@ namespace vt::widgets
 			int64_t frame_count = std::max<int64_t>(time_max - time_min, 1);
 
 			static bool moving_scroll_bar = false;
-			static bool moving_time_marker = false;
 
 			// zoom in/out
 			const int64_t visibleFrameCount = (int64_t)floorf((canvas_size.x - legend_width) / frame_pixel_width);
@@ -271,8 +333,12 @@ namespace vt::widgets
 				// test scroll area
 				ImGui::InvisibleButton("##TopBar", header_size);
 				draw_list->AddRectFilled(canvas_pos, canvas_pos + header_size, 0xFFFF0000, 0);
+				if (show_filmstrip)
+				{
+					ImGui::InvisibleButton("##Filmstrip", ImVec2(canvas_size.x, filmstrip_height));
+				}
 				ImVec2 childFramePos = ImGui::GetCursorScreenPos();
-				ImVec2 childFrameSize(canvas_size.x, canvas_size.y - 8.f - header_size.y - (has_scroll_bar ? scroll_bar_size.y : 0));
+				ImVec2 childFrameSize(canvas_size.x, canvas_size.y - 8.f - header_size.y - filmstrip_height - (has_scroll_bar ? scroll_bar_size.y : 0));
 				//ImGui::PushStyleColor(ImGuiCol_FrameBg, 0);
 				ImGui::BeginChild("##Frame", childFrameSize, ImGuiChildFlags_FrameStyle);
 
@@ -349,14 +415,14 @@ namespace vt::widgets
 				ImU32 bg_color = ImGui::ColorConvertFloat4ToU32(style.Colors[ImGuiCol_MenuBarBg]); //0xFF242424
 				draw_list->AddRectFilled(canvas_pos, canvas_pos + canvas_size, bg_color, 0);
 
-				// current frame top
-				ImRect topRect(ImVec2(canvas_pos.x + legend_width, canvas_pos.y), ImVec2(canvas_pos.x + canvas_size.x, canvas_pos.y + item_height));
+				// current frame top, the filmstrip can be scrubbed the same way
+				ImRect topRect(ImVec2(canvas_pos.x + legend_width, canvas_pos.y), ImVec2(canvas_pos.x + canvas_size.x, canvas_pos.y + item_height + filmstrip_height));
 
-				if (enabled_ and !moving_time_marker and !moving_scroll_bar and !moving_segment.has_value() and current_time_.total_milliseconds.count() >= 0 and topRect.Contains(io.MousePos) and io.MouseClicked[0] and !ImGui::IsPopupOpen(nullptr, ImGuiPopupFlags_AnyPopup | ImGuiPopupFlags_AnyPopupId))
+				if (enabled_ and !moving_time_marker_ and !moving_scroll_bar and !moving_segment.has_value() and current_time_.total_milliseconds.count() >= 0 and topRect.Contains(io.MousePos) and io.MouseClicked[0] and !ImGui::IsPopupOpen(nullptr, ImGuiPopupFlags_AnyPopup | ImGuiPopupFlags_AnyPopupId))
 				{
-					moving_time_marker = true;
+					moving_time_marker_ = true;
 				}
-				if (moving_time_marker)
+				if (moving_time_marker_)
 				{
 					if (frame_count)
 					{
@@ -372,7 +438,7 @@ namespace vt::widgets
 					}
 					if (!io.MouseDown[0])
 					{
-						moving_time_marker = false;
+						moving_time_marker_ = false;
 					}
 				}
 
@@ -463,6 +529,58 @@ namespace vt::widgets
 				}
 				drawLine(time_min, item_height);
 				drawLine(time_max, item_height);
+
+				if (show_filmstrip)
+				{
+					auto filmstrips = group_filmstrips(current_video_group_id_);
+					const ImRect filmstrip_rect(ImVec2(canvas_pos.x + legend_width, canvas_pos.y + item_height), ImVec2(canvas_pos.x + canvas_size.x, canvas_pos.y + item_height + filmstrip_height));
+					auto x_to_timestamp = [&](float x)
+					{
+						return std::chrono::nanoseconds{ std::chrono::milliseconds{ first_frame_used + static_cast<int64_t>((x - filmstrip_rect.Min.x) / frame_pixel_width) } };
+					};
+
+					// Tiles start at multiples of their duration, so they don't change while the view is scrolled
+					const float tile_width = filmstrip_height * 16.f / 9.f;
+					const int64_t tile_duration = std::max<int64_t>(static_cast<int64_t>(tile_width / frame_pixel_width), 1);
+					draw_list->PushClipRect(filmstrip_rect.Min, filmstrip_rect.Max, true);
+					for (int64_t tile_start = first_frame_used - (first_frame_used % tile_duration + tile_duration) % tile_duration; ; tile_start += tile_duration)
+					{
+						float x = filmstrip_rect.Min.x + (tile_start - first_frame_used) * frame_pixel_width;
+						if (x >= filmstrip_rect.Max.x)
+						{
+							break;
+						}
+
+						auto frames = filmstrip_frames_at(filmstrips, x_to_timestamp(x + tile_width / 2));
+						if (!frames.empty())
+						{
+							const auto& frame = frames.front();
+							float width = std::min(frame.size.x * filmstrip_height / frame.size.y, tile_width);
+							ImVec2 tile_min(x + (tile_width - width) / 2, filmstrip_rect.Min.y);
+							draw_list->AddImage(reinterpret_cast<ImTextureID>((uintptr_t)frame.texture), tile_min, tile_min + ImVec2(width, filmstrip_height), frame.uv0, frame.uv1);
+						}
+					}
+					draw_list->PopClipRect();
+
+					// Hover preview of every video playing at the hovered time
+					if (topRect.Contains(io.MousePos) and ImGui::IsWindowHovered(ImGuiHoveredFlags_RootAndChildWindows) and !moving_segment.has_value() and !ImGui::IsPopupOpen(nullptr, ImGuiPopupFlags_AnyPopup | ImGuiPopupFlags_AnyPopupId))
+					{
+						auto hovered_timestamp = x_to_timestamp(io.MousePos.x);
+						auto frames = filmstrip_frames_at(filmstrips, hovered_timestamp);
+						if (!frames.empty())
+						{
+							ImGui::BeginTooltip();
+							for (const auto& frame : frames)
+							{
+								ImGui::Image(reinterpret_cast<ImTextureID>((uintptr_t)frame.texture), frame.size, frame.uv0, frame.uv1);
+								ImGui::SameLine();
+							}
+							ImGui::NewLine();
+							ImGui::TextUnformatted(utils::time::time_to_string(std::chrono::duration_cast<std::chrono::milliseconds>(hovered_timestamp).count()).c_str());
+							ImGui::EndTooltip();
+						}
+					}
+				}
 				/*
 				draw_list->AddLine(canvas_pos, ImVec2(canvas_pos.x, canvas_pos.y + controlHeight), 0xFF000000, 1);
 				draw_list->AddLine(ImVec2(canvas_pos.x, canvas_pos.y + ItemHeight), ImVec2(canvas_size.x, canvas_pos.y + ItemHeight), 0xFF000000, 1);
@@ -625,7 +743,7 @@ namespace vt::widgets
 										continue;
 									if (!ImRect(childFramePos, childFramePos + childFrameSize).Contains(io.MousePos))
 										continue;
-									if (ImGui::IsMouseClicked(0) and !moving_scroll_bar and !moving_time_marker and (segment_it->type() != tag_segment_type::timestamp or j == 2))
+									if (ImGui::IsMouseClicked(0) and !moving_scroll_bar and !moving_time_marker_ and (segment_it->type() != tag_segment_type::timestamp or j == 2))
 									{
 										moving_segment = moving_segment_data
 										{
@@ -106,6 +106,9 @@ namespace vt::widgets
 		void set_current_timestamp(timestamp ts);
 		timestamp current_timestamp() const;
 
+		//True while the time marker is being dragged
+		bool is_scrubbing() const;
+
 		void render(bool& open);
 
 		static std::string window_name();
@@ -113,6 +116,7 @@ namespace vt::widgets
 	private:
 		bool focused_ = false;
 		bool enabled_ = true;
+		bool moving_time_marker_ = false;
 		
 		vt::tag_storage* tags_{};
 		vt::segment_storage* segments_{};
@@ -11,9 +11,10 @@
 
 namespace vt::widgets
 {
-	void draw_video_widget(video_stream& video, const gl_texture& video_texture, bool is_video_active, bool& is_open, uint64_t id, const std::function<void(ImVec2, ImVec2, ImVec2)>& draw_overlay)
+	ImVec2 draw_video_widget(video_stream& video, const gl_texture& video_texture, bool is_video_active, bool& is_open, uint64_t id, const std::function<void(ImVec2, ImVec2, ImVec2)>& draw_overlay)
 	{
 		auto& io = ImGui::GetIO();
+		ImVec2 result{};
 		ImGuiWindowFlags flags = ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoScrollWithMouse | ImGuiWindowFlags_NoSavedSettings;
 		if (video.is_open())
 		{
@@ -80,6 +81,7 @@ namespace vt::widgets
 				auto video_screen_pos = ImGui::GetCursorScreenPos();
 
 				ImGui::Image(reinterpret_cast<ImTextureID>((uintptr_t)video_texture.id()), image_size);
+				result = image_size * io.DisplayFramebufferScale;
 
 				if (!is_video_active)
 				{
@@ -101,7 +103,8 @@ namespace vt::widgets
 				}
 				else
 				{
-					draw_overlay(video_screen_pos, image_size, { (float)video_texture.width(), (float)video_texture.height() });
+					// Shapes are stored in video pixels, the texture can be smaller than the video
+					draw_overlay(video_screen_pos, image_size, { (float)video_width, (float)video_height });
 				}
 
 				auto video_ts = video.current_timestamp();
@@ -210,5 +213,7 @@ namespace vt::widgets
 			ImGui::PopID();
 		}
 		ImGui::End();
+
+		return result;
 	}
 }
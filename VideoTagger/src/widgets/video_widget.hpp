@@ -1,8 +1,11 @@
 #pragma once
 #include <functional>
+#include <imgui.h>
 #include <video/video_stream.hpp>
 
 namespace vt::widgets
 {
-	extern void draw_video_widget(video_stream& video, const gl_texture& video_texture, bool is_video_active, bool& is_open, uint64_t id, const std::function<void(ImVec2, ImVec2, ImVec2)>& draw_overlay = nullptr);
+	//Returns the size of the displayed image in framebuffer pixels, zero if it wasn't drawn
+	//tex_size passed to draw_overlay is the native size of the video, not the size of the texture
+	extern ImVec2 draw_video_widget(video_stream& video, const gl_texture& video_texture, bool is_video_active, bool& is_open, uint64_t id, const std::function<void(ImVec2, ImVec2, ImVec2)>& draw_overlay = nullptr);
 }